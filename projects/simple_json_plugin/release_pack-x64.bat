@@ -17,6 +17,10 @@ mkdir "%TMP_PACK_DIR%\stream_plugins"
 mkdir "%TMP_PACK_DIR%\doc"
 
 copy "%BUILD_DIR%\simple_json_plugin.dll" "%TMP_PACK_DIR%\stream_plugins\simple_json_plugin.dll"
+copy "%BUILD_DIR%\zlib1.dll" "%TMP_PACK_DIR%\stream_plugins\zlib1.dll"
+copy "%BUILD_DIR%\zstd.dll" "%TMP_PACK_DIR%\stream_plugins\zstd.dll"
+copy "%BUILD_DIR%\arrow.dll" "%TMP_PACK_DIR%\stream_plugins\arrow.dll"
+copy "%BUILD_DIR%\parquet.dll" "%TMP_PACK_DIR%\stream_plugins\parquet.dll"
 copy "%DOC_DIR%\simple_json_plugin.md" "%TMP_PACK_DIR%\doc\simple_json_plugin.md"
 copy "%DOC_DIR%\simple_json_plugin_ru.md" "%TMP_PACK_DIR%\doc\simple_json_plugin_ru.md"
 copy "%PROJECT_DIR%\fb_streaming.conf" "%TMP_PACK_DIR%\fb_streaming.conf"
@@ -0,0 +1,526 @@
+#include "BenchmarkMocks.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include "../../common/Utils.h"
+#include "../../common/charsets.h"
+
+using namespace Firebird;
+
+namespace {
+
+std::array<char32_t, 256> makeLatin1Table()
+{
+    std::array<char32_t, 256> table {};
+    for (unsigned i = 0; i < 256; i++) {
+        table[i] = i;
+    }
+    return table;
+}
+
+// The upper half of WIN1251 is approximated: letters are exact, other characters
+// are mapped to Cyrillic supplement code points of the same UTF-8 length.
+std::array<char32_t, 256> makeWin1251Table()
+{
+    std::array<char32_t, 256> table {};
+    for (unsigned i = 0; i < 0x80; i++) {
+        table[i] = i;
+    }
+    for (unsigned i = 0x80; i < 0xC0; i++) {
+        table[i] = 0x0400 + (i - 0x80);
+    }
+    for (unsigned i = 0xC0; i < 0x100; i++) {
+        table[i] = 0x0410 + (i - 0xC0);
+    }
+    return table;
+}
+
+unsigned encodeUtf8(char32_t codePoint, char* dest)
+{
+    if (codePoint < 0x80) {
+        dest[0] = static_cast<char>(codePoint);
+        return 1;
+    }
+    if (codePoint < 0x800) {
+        dest[0] = static_cast<char>(0xC0 | (codePoint >> 6));
+        dest[1] = static_cast<char>(0x80 | (codePoint & 0x3F));
+        return 2;
+    }
+    dest[0] = static_cast<char>(0xE0 | (codePoint >> 12));
+    dest[1] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+    dest[2] = static_cast<char>(0x80 | (codePoint & 0x3F));
+    return 3;
+}
+
+[[noreturn]] void notImplemented(const char* method)
+{
+    FbUtils::raiseError("%s is not implemented by the benchmark", method);
+}
+
+} // namespace
+
+namespace SimpleJsonBenchmark {
+
+// MockConfigEntry
+
+MockConfigEntry::MockConfigEntry(const std::string& name, const std::string& value)
+    : m_name(name)
+    , m_value(value)
+    , m_refCounter(1)
+{
+}
+
+void MockConfigEntry::addRef()
+{
+    ++m_refCounter;
+}
+
+int MockConfigEntry::release()
+{
+    if (--m_refCounter == 0) {
+        delete this;
+        return 0;
+    }
+    return 1;
+}
+
+const char* MockConfigEntry::getName()
+{
+    return m_name.c_str();
+}
+
+const char* MockConfigEntry::getValue()
+{
+    return m_value.c_str();
+}
+
+ISC_INT64 MockConfigEntry::getIntValue()
+{
+    return std::stoll(m_value);
+}
+
+FB_BOOLEAN MockConfigEntry::getBoolValue()
+{
+    return (m_value == "true" || m_value == "yes" || m_value == "1") ? FB_TRUE : FB_FALSE;
+}
+
+IConfig* MockConfigEntry::getSubConfig([[maybe_unused]] ThrowStatusWrapper* status)
+{
+    return nullptr;
+}
+
+// MockConfig
+
+MockConfig::MockConfig()
+    : m_values()
+    , m_refCounter(1)
+{
+}
+
+void MockConfig::setValue(const std::string& name, const std::string& value)
+{
+    m_values[name] = value;
+}
+
+void MockConfig::addRef()
+{
+    ++m_refCounter;
+}
+
+int MockConfig::release()
+{
+    if (--m_refCounter == 0) {
+        delete this;
+        return 0;
+    }
+    return 1;
+}
+
+IConfigEntry* MockConfig::find([[maybe_unused]] ThrowStatusWrapper* status, const char* name)
+{
+    auto it = m_values.find(name);
+    if (it == m_values.end()) {
+        return nullptr;
+    }
+    return new MockConfigEntry(it->first, it->second);
+}
+
+IConfigEntry* MockConfig::findValue([[maybe_unused]] ThrowStatusWrapper* status, const char* name, const char* value)
+{
+    auto it = m_values.find(name);
+    if (it == m_values.end() || it->second != value) {
+        return nullptr;
+    }
+    return new MockConfigEntry(it->first, it->second);
+}
+
+IConfigEntry* MockConfig::findPos(ThrowStatusWrapper* status, const char* name, unsigned pos)
+{
+    // each parameter has a single value
+    return (pos == 0) ? find(status, name) : nullptr;
+}
+
+// MockLogger
+
+MockLogger::MockLogger()
+    : m_level(LEVEL_WARN)
+{
+}
+
+void MockLogger::dispose()
+{
+}
+
+unsigned MockLogger::getLevel()
+{
+    return m_level;
+}
+
+void MockLogger::setLevel(unsigned logLevel)
+{
+    m_level = logLevel;
+}
+
+void MockLogger::log(unsigned level, const char* message)
+{
+    if (level >= m_level) {
+        std::fprintf(stderr, "%s\n", message);
+    }
+}
+
+void MockLogger::trace(const char* message)
+{
+    log(LEVEL_TRACE, message);
+}
+
+void MockLogger::debug(const char* message)
+{
+    log(LEVEL_DEBUG, message);
+}
+
+void MockLogger::info(const char* message)
+{
+    log(LEVEL_INFO, message);
+}
+
+void MockLogger::warning(const char* message)
+{
+    log(LEVEL_WARN, message);
+}
+
+void MockLogger::error(const char* message)
+{
+    log(LEVEL_ERROR, message);
+}
+
+void MockLogger::critical(const char* message)
+{
+    log(LEVEL_CRITICAL, message);
+}
+
+void MockLogger::flush()
+{
+}
+
+// MockStringConverter
+
+MockStringConverter::MockStringConverter(unsigned charsetId, const char* charsetName, const std::array<char32_t, 256>& codePoints)
+    : m_charsetId(charsetId)
+    , m_charsetName(charsetName)
+    , m_codePoints(codePoints)
+    , m_refCounter(1)
+{
+}
+
+void MockStringConverter::addRef()
+{
+    ++m_refCounter;
+}
+
+int MockStringConverter::release()
+{
+    if (--m_refCounter == 0) {
+        delete this;
+        return 0;
+    }
+    return 1;
+}
+
+int MockStringConverter::getMaxCharSize()
+{
+    return 1;
+}
+
+int MockStringConverter::getMinCharSize()
+{
+    return 1;
+}
+
+unsigned MockStringConverter::getCharsetId()
+{
+    return m_charsetId;
+}
+
+const char* MockStringConverter::getCharsetName()
+{
+    return m_charsetName.c_str();
+}
+
+ISC_UINT64 MockStringConverter::toUtf8([[maybe_unused]] ThrowStatusWrapper* status, const char* src, ISC_UINT64 srcSize,
+    char* destBuffer, ISC_UINT64 destBufferSize)
+{
+    ISC_UINT64 length = 0;
+    for (ISC_UINT64 i = 0; i < srcSize; i++) {
+        const auto codePoint = m_codePoints[static_cast<unsigned char>(src[i])];
+        // a character takes at most 3 bytes
+        if (length + 3 > destBufferSize) {
+            FbUtils::raiseError("Destination buffer of %llu bytes is too small", static_cast<unsigned long long>(destBufferSize));
+        }
+        length += encodeUtf8(codePoint, destBuffer + length);
+    }
+    return length;
+}
+
+ISC_UINT64 MockStringConverter::fromUtf8(ThrowStatusWrapper*, const char*, ISC_UINT64, char*, ISC_UINT64)
+{
+    notImplemented("IStringConverter::fromUtf8");
+}
+
+ISC_UINT64 MockStringConverter::toUtf16(ThrowStatusWrapper*, const char*, ISC_UINT64, void*, ISC_UINT64)
+{
+    notImplemented("IStringConverter::toUtf16");
+}
+
+ISC_UINT64 MockStringConverter::fromUtf16(ThrowStatusWrapper*, const void*, ISC_UINT64, char*, ISC_UINT64)
+{
+    notImplemented("IStringConverter::fromUtf16");
+}
+
+ISC_UINT64 MockStringConverter::toUtf32(ThrowStatusWrapper*, const char*, ISC_UINT64, void*, ISC_UINT64)
+{
+    notImplemented("IStringConverter::toUtf32");
+}
+
+ISC_UINT64 MockStringConverter::fromUtf32(ThrowStatusWrapper*, const void*, ISC_UINT64, char*, ISC_UINT64)
+{
+    notImplemented("IStringConverter::fromUtf32");
+}
+
+ISC_UINT64 MockStringConverter::toWCS(ThrowStatusWrapper*, const char*, ISC_UINT64, void*, ISC_UINT64)
+{
+    notImplemented("IStringConverter::toWCS");
+}
+
+ISC_UINT64 MockStringConverter::fromWCS(ThrowStatusWrapper*, const void*, ISC_UINT64, char*, ISC_UINT64)
+{
+    notImplemented("IStringConverter::fromWCS");
+}
+
+// MockEncodeUtils
+
+MockEncodeUtils::MockEncodeUtils()
+{
+}
+
+void MockEncodeUtils::dispose()
+{
+}
+
+IStringConverter* MockEncodeUtils::getConverterById([[maybe_unused]] ThrowStatusWrapper* status, unsigned charsetId)
+{
+    switch (charsetId) {
+    case CS_WIN1251:
+        return new MockStringConverter(charsetId, "WIN1251", makeWin1251Table());
+    case CS_ISO8859_1:
+        return new MockStringConverter(charsetId, "ISO8859_1", makeLatin1Table());
+    default:
+        FbUtils::raiseError("Character set %u is not supported by the benchmark", charsetId);
+    }
+}
+
+IStringConverter* MockEncodeUtils::getConverterByName(ThrowStatusWrapper* status, const char* charsetName)
+{
+    if (strcmp(charsetName, "WIN1251") == 0) {
+        return getConverterById(status, CS_WIN1251);
+    }
+    if (strcmp(charsetName, "ISO8859_1") == 0) {
+        return getConverterById(status, CS_ISO8859_1);
+    }
+    FbUtils::raiseError("Character set %s is not supported by the benchmark", charsetName);
+}
+
+ISC_UINT64 MockEncodeUtils::convertCharset(ThrowStatusWrapper*, IStringConverter*, IStringConverter*,
+    const char*, ISC_UINT64, char*, ISC_UINT64)
+{
+    notImplemented("IStringEncodeUtils::convertCharset");
+}
+
+ISC_UINT64 MockEncodeUtils::convertUtf8ToWCS(ThrowStatusWrapper*, const char*, ISC_UINT64, void*, ISC_UINT64)
+{
+    notImplemented("IStringEncodeUtils::convertUtf8ToWCS");
+}
+
+ISC_UINT64 MockEncodeUtils::convertUtf8ToUtf16(ThrowStatusWrapper*, const char*, ISC_UINT64, void*, ISC_UINT64)
+{
+    notImplemented("IStringEncodeUtils::convertUtf8ToUtf16");
+}
+
+ISC_UINT64 MockEncodeUtils::convertUtf8ToUtf32(ThrowStatusWrapper*, const char*, ISC_UINT64, void*, ISC_UINT64)
+{
+    notImplemented("IStringEncodeUtils::convertUtf8ToUtf32");
+}
+
+ISC_UINT64 MockEncodeUtils::convertUtf16ToWCS(ThrowStatusWrapper*, const void*, ISC_UINT64, void*, ISC_UINT64)
+{
+    notImplemented("IStringEncodeUtils::convertUtf16ToWCS");
+}
+
+ISC_UINT64 MockEncodeUtils::convertUtf16ToUtf8(ThrowStatusWrapper*, const void*, ISC_UINT64, char*, ISC_UINT64)
+{
+    notImplemented("IStringEncodeUtils::convertUtf16ToUtf8");
+}
+
+ISC_UINT64 MockEncodeUtils::convertUtf16ToUtf32(ThrowStatusWrapper*, const void*, ISC_UINT64, void*, ISC_UINT64)
+{
+    notImplemented("IStringEncodeUtils::convertUtf16ToUtf32");
+}
+
+ISC_UINT64 MockEncodeUtils::convertUtf32ToWCS(ThrowStatusWrapper*, const void*, ISC_UINT64, void*, ISC_UINT64)
+{
+    notImplemented("IStringEncodeUtils::convertUtf32ToWCS");
+}
+
+ISC_UINT64 MockEncodeUtils::convertUtf32ToUtf8(ThrowStatusWrapper*, const void*, ISC_UINT64, char*, ISC_UINT64)
+{
+    notImplemented("IStringEncodeUtils::convertUtf32ToUtf8");
+}
+
+ISC_UINT64 MockEncodeUtils::convertUtf32ToUtf16(ThrowStatusWrapper*, const void*, ISC_UINT64, void*, ISC_UINT64)
+{
+    notImplemented("IStringEncodeUtils::convertUtf32ToUtf16");
+}
+
+ISC_UINT64 MockEncodeUtils::convertWCSToUtf8(ThrowStatusWrapper*, const void*, ISC_UINT64, char*, ISC_UINT64)
+{
+    notImplemented("IStringEncodeUtils::convertWCSToUtf8");
+}
+
+ISC_UINT64 MockEncodeUtils::convertWCSToUtf16(ThrowStatusWrapper*, const void*, ISC_UINT64, void*, ISC_UINT64)
+{
+    notImplemented("IStringEncodeUtils::convertWCSToUtf16");
+}
+
+ISC_UINT64 MockEncodeUtils::convertWCSToUtf32(ThrowStatusWrapper*, const void*, ISC_UINT64, void*, ISC_UINT64)
+{
+    notImplemented("IStringEncodeUtils::convertWCSToUtf32");
+}
+
+// MockField
+
+MockField::MockField(const std::string& name, unsigned type, int subType, int scale, unsigned length, unsigned charset)
+    : m_name(name)
+    , m_type(type)
+    , m_subType(subType)
+    , m_scale(scale)
+    , m_length(length)
+    , m_charset(charset)
+    // VARCHAR data is preceded by its length
+    , m_data((type == SQL_VARYING) ? length + sizeof(ISC_USHORT) : length)
+    , m_null(false)
+{
+}
+
+void MockField::setData(const void* data, size_t size)
+{
+    memcpy(m_data.data(), data, std::min(size, m_data.size()));
+    m_null = false;
+}
+
+void MockField::setNull(bool isNull)
+{
+    m_null = isNull;
+}
+
+const char* MockField::getName()
+{
+    return m_name.c_str();
+}
+
+unsigned MockField::getType()
+{
+    return m_type;
+}
+
+int MockField::getSubType()
+{
+    return m_subType;
+}
+
+int MockField::getScale()
+{
+    return m_scale;
+}
+
+unsigned MockField::getLength()
+{
+    return m_length;
+}
+
+unsigned MockField::getCharSet()
+{
+    return m_charset;
+}
+
+const void* MockField::getData()
+{
+    return m_null ? nullptr : m_data.data();
+}
+
+FB_BOOLEAN MockField::isKey()
+{
+    return FB_FALSE;
+}
+
+unsigned MockField::keyPosition()
+{
+    return 0;
+}
+
+// MockRecord
+
+MockRecord::MockRecord()
+    : m_fields()
+    , m_rawLength(0)
+{
+}
+
+MockField& MockRecord::addField(const std::string& name, unsigned type, int subType, int scale, unsigned length, unsigned charset)
+{
+    m_fields.push_back(std::make_unique<MockField>(name, type, subType, scale, length, charset));
+    m_rawLength += static_cast<unsigned>(m_fields.back()->getBufferSize());
+    return *m_fields.back();
+}
+
+unsigned MockRecord::getCount()
+{
+    return static_cast<unsigned>(m_fields.size());
+}
+
+IStreamedField* MockRecord::getField(unsigned index)
+{
+    return (index < m_fields.size()) ? m_fields[index].get() : nullptr;
+}
+
+unsigned MockRecord::getRawLength()
+{
+    return m_rawLength;
+}
+
+const unsigned char* MockRecord::getRawData()
+{
+    return nullptr;
+}
+
+} // namespace SimpleJsonBenchmark
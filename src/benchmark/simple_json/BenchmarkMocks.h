@@ -0,0 +1,194 @@
+#pragma once
+#ifndef SIMPLE_JSON_BENCHMARK_MOCKS_H
+#define SIMPLE_JSON_BENCHMARK_MOCKS_H
+
+#include <array>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../../include/StreamingInterface.h"
+
+// In-process implementations of the interfaces that fb_streaming passes to the plugin.
+// They do as little work as possible, so that the measured time is spent in the plugin.
+namespace SimpleJsonBenchmark {
+
+class MockConfigEntry final : public Firebird::IConfigEntryImpl<MockConfigEntry, Firebird::ThrowStatusWrapper> {
+public:
+    MockConfigEntry(const std::string& name, const std::string& value);
+
+    // IReferenceCounted implementation
+    void addRef() override;
+    int release() override;
+
+    // IConfigEntry implementation
+    const char* getName() override;
+    const char* getValue() override;
+    ISC_INT64 getIntValue() override;
+    FB_BOOLEAN getBoolValue() override;
+    Firebird::IConfig* getSubConfig(Firebird::ThrowStatusWrapper* status) override;
+
+private:
+    std::string m_name;
+    std::string m_value;
+    std::atomic_int m_refCounter = 1;
+};
+
+// Plugin configuration given as name/value pairs.
+class MockConfig final : public Firebird::IConfigImpl<MockConfig, Firebird::ThrowStatusWrapper> {
+public:
+    MockConfig();
+
+    void setValue(const std::string& name, const std::string& value);
+
+    // IReferenceCounted implementation
+    void addRef() override;
+    int release() override;
+
+    // IConfig implementation
+    Firebird::IConfigEntry* find(Firebird::ThrowStatusWrapper* status, const char* name) override;
+    Firebird::IConfigEntry* findValue(Firebird::ThrowStatusWrapper* status, const char* name, const char* value) override;
+    Firebird::IConfigEntry* findPos(Firebird::ThrowStatusWrapper* status, const char* name, unsigned pos) override;
+
+private:
+    std::map<std::string, std::string> m_values;
+    std::atomic_int m_refCounter = 1;
+};
+
+// Drops all messages except errors, which are printed to stderr.
+class MockLogger final : public Firebird::IStreamLoggerImpl<MockLogger, Firebird::ThrowStatusWrapper> {
+public:
+    MockLogger();
+
+    // IDisposable implementation
+    void dispose() override;
+
+    // IStreamLogger implementation
+    unsigned getLevel() override;
+    void setLevel(unsigned logLevel) override;
+    void log(unsigned level, const char* message) override;
+    void trace(const char* message) override;
+    void debug(const char* message) override;
+    void info(const char* message) override;
+    void warning(const char* message) override;
+    void error(const char* message) override;
+    void critical(const char* message) override;
+    void flush() override;
+
+private:
+    unsigned m_level = LEVEL_WARN;
+};
+
+// Single-byte character set converter driven by a table of code points.
+// Only the conversion to UTF-8 is implemented, the plugin does not need others.
+class MockStringConverter final : public Firebird::IStringConverterImpl<MockStringConverter, Firebird::ThrowStatusWrapper> {
+public:
+    MockStringConverter(unsigned charsetId, const char* charsetName, const std::array<char32_t, 256>& codePoints);
+
+    // IReferenceCounted implementation
+    void addRef() override;
+    int release() override;
+
+    // IStringConverter implementation
+    int getMaxCharSize() override;
+    int getMinCharSize() override;
+    unsigned getCharsetId() override;
+    const char* getCharsetName() override;
+    ISC_UINT64 toUtf8(Firebird::ThrowStatusWrapper* status, const char* src, ISC_UINT64 srcSize, char* destBuffer, ISC_UINT64 destBufferSize) override;
+    ISC_UINT64 fromUtf8(Firebird::ThrowStatusWrapper* status, const char* src, ISC_UINT64 srcSize, char* destBuffer, ISC_UINT64 destBufferSize) override;
+    ISC_UINT64 toUtf16(Firebird::ThrowStatusWrapper* status, const char* src, ISC_UINT64 srcSize, void* destBuffer, ISC_UINT64 destBufferSize) override;
+    ISC_UINT64 fromUtf16(Firebird::ThrowStatusWrapper* status, const void* src, ISC_UINT64 srcSize, char* destBuffer, ISC_UINT64 destBufferSize) override;
+    ISC_UINT64 toUtf32(Firebird::ThrowStatusWrapper* status, const char* src, ISC_UINT64 srcSize, void* destBuffer, ISC_UINT64 destBufferSize) override;
+    ISC_UINT64 fromUtf32(Firebird::ThrowStatusWrapper* status, const void* src, ISC_UINT64 srcSize, char* destBuffer, ISC_UINT64 destBufferSize) override;
+    ISC_UINT64 toWCS(Firebird::ThrowStatusWrapper* status, const char* src, ISC_UINT64 srcSize, void* destBuffer, ISC_UINT64 destBufferSize) override;
+    ISC_UINT64 fromWCS(Firebird::ThrowStatusWrapper* status, const void* src, ISC_UINT64 srcSize, char* destBuffer, ISC_UINT64 destBufferSize) override;
+
+private:
+    unsigned m_charsetId;
+    std::string m_charsetName;
+    std::array<char32_t, 256> m_codePoints;
+    std::atomic_int m_refCounter = 1;
+};
+
+// Provides converters for WIN1251 and ISO8859_1.
+class MockEncodeUtils final : public Firebird::IStringEncodeUtilsImpl<MockEncodeUtils, Firebird::ThrowStatusWrapper> {
+public:
+    MockEncodeUtils();
+
+    // IDisposable implementation
+    void dispose() override;
+
+    // IStringEncodeUtils implementation
+    Firebird::IStringConverter* getConverterById(Firebird::ThrowStatusWrapper* status, unsigned charsetId) override;
+    Firebird::IStringConverter* getConverterByName(Firebird::ThrowStatusWrapper* status, const char* charsetName) override;
+    ISC_UINT64 convertCharset(Firebird::ThrowStatusWrapper* status, Firebird::IStringConverter* srcConveter, Firebird::IStringConverter* dstConveter,
+        const char* src, ISC_UINT64 srcSize, char* destBuffer, ISC_UINT64 destBufferSize) override;
+    ISC_UINT64 convertUtf8ToWCS(Firebird::ThrowStatusWrapper* status, const char* src, ISC_UINT64 srcSize, void* destBuffer, ISC_UINT64 destBufferSize) override;
+    ISC_UINT64 convertUtf8ToUtf16(Firebird::ThrowStatusWrapper* status, const char* src, ISC_UINT64 srcSize, void* destBuffer, ISC_UINT64 destBufferSize) override;
+    ISC_UINT64 convertUtf8ToUtf32(Firebird::ThrowStatusWrapper* status, const char* src, ISC_UINT64 srcSize, void* destBuffer, ISC_UINT64 destBufferSize) override;
+    ISC_UINT64 convertUtf16ToWCS(Firebird::ThrowStatusWrapper* status, const void* src, ISC_UINT64 srcSize, void* destBuffer, ISC_UINT64 destBufferSize) override;
+    ISC_UINT64 convertUtf16ToUtf8(Firebird::ThrowStatusWrapper* status, const void* src, ISC_UINT64 srcSize, char* destBuffer, ISC_UINT64 destBufferSize) override;
+    ISC_UINT64 convertUtf16ToUtf32(Firebird::ThrowStatusWrapper* status, const void* src, ISC_UINT64 srcSize, void* destBuffer, ISC_UINT64 destBufferSize) override;
+    ISC_UINT64 convertUtf32ToWCS(Firebird::ThrowStatusWrapper* status, const void* src, ISC_UINT64 srcSize, void* destBuffer, ISC_UINT64 destBufferSize) override;
+    ISC_UINT64 convertUtf32ToUtf8(Firebird::ThrowStatusWrapper* status, const void* src, ISC_UINT64 srcSize, char* destBuffer, ISC_UINT64 destBufferSize) override;
+    ISC_UINT64 convertUtf32ToUtf16(Firebird::ThrowStatusWrapper* status, const void* src, ISC_UINT64 srcSize, void* destBuffer, ISC_UINT64 destBufferSize) override;
+    ISC_UINT64 convertWCSToUtf8(Firebird::ThrowStatusWrapper* status, const void* src, ISC_UINT64 srcSize, char* destBuffer, ISC_UINT64 destBufferSize) override;
+    ISC_UINT64 convertWCSToUtf16(Firebird::ThrowStatusWrapper* status, const void* src, ISC_UINT64 srcSize, void* destBuffer, ISC_UINT64 destBufferSize) override;
+    ISC_UINT64 convertWCSToUtf32(Firebird::ThrowStatusWrapper* status, const void* src, ISC_UINT64 srcSize, void* destBuffer, ISC_UINT64 destBufferSize) override;
+};
+
+class MockField final : public Firebird::IStreamedFieldImpl<MockField, Firebird::ThrowStatusWrapper> {
+public:
+    MockField(const std::string& name, unsigned type, int subType, int scale, unsigned length, unsigned charset);
+
+    // the value is copied into the field buffer
+    void setData(const void* data, size_t size);
+    void setNull(bool isNull);
+    unsigned char* getBuffer() { return m_data.data(); }
+    size_t getBufferSize() const { return m_data.size(); }
+
+    // IStreamedField implementation
+    const char* getName() override;
+    unsigned getType() override;
+    int getSubType() override;
+    int getScale() override;
+    unsigned getLength() override;
+    unsigned getCharSet() override;
+    const void* getData() override;
+    FB_BOOLEAN isKey() override;
+    unsigned keyPosition() override;
+
+private:
+    std::string m_name;
+    unsigned m_type;
+    int m_subType;
+    int m_scale;
+    unsigned m_length;
+    unsigned m_charset;
+    std::vector<unsigned char> m_data;
+    bool m_null = false;
+};
+
+class MockRecord final : public Firebird::IStreamedRecordImpl<MockRecord, Firebird::ThrowStatusWrapper> {
+public:
+    MockRecord();
+
+    MockField& addField(const std::string& name, unsigned type, int subType, int scale, unsigned length, unsigned charset);
+    MockField& field(unsigned index) { return *m_fields[index]; }
+
+    // IStreamedRecord implementation
+    unsigned getCount() override;
+    Firebird::IStreamedField* getField(unsigned index) override;
+    unsigned getRawLength() override;
+    const unsigned char* getRawData() override;
+
+private:
+    std::vector<std::unique_ptr<MockField>> m_fields;
+    unsigned m_rawLength = 0;
+};
+
+} // namespace SimpleJsonBenchmark
+
+#endif // SIMPLE_JSON_BENCHMARK_MOCKS_H
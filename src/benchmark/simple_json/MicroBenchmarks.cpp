@@ -0,0 +1,256 @@
+#include "MicroBenchmarks.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../../common/BinaryEncoding.h"
+#include "../../common/LazyFactory.h"
+#include "../../common/charsets.h"
+#include "../../encoding/StringConverterCache.h"
+#include "../../encoding/StringEncodeHelper.h"
+#include "../../plugins/simple_json/RecordLayout.h"
+#include "BenchmarkMocks.h"
+
+namespace {
+
+using namespace Firebird;
+using FbUtils::SimdLevel;
+using SimpleJsonBenchmark::MockEncodeUtils;
+using SimpleJsonBenchmark::MockRecord;
+using SimpleJsonPlugin::RecordLayout;
+
+// minimal measured time of one implementation
+constexpr double MIN_SECONDS = 0.5;
+
+// Calls f until MIN_SECONDS pass, returns the number of calls per second.
+template <typename F>
+double callsPerSecond(F&& f)
+{
+    using Clock = std::chrono::steady_clock;
+
+    uint64_t iterations = 0;
+    double seconds = 0;
+    const auto start = Clock::now();
+    do {
+        f();
+        ++iterations;
+        seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    } while (seconds < MIN_SECONDS);
+    return static_cast<double>(iterations) / seconds;
+}
+
+// Prints the throughput in GB/s of input, f processes size bytes.
+template <typename F>
+void measure(const char* name, size_t size, F&& f)
+{
+    const double gigabytes = static_cast<double>(size) * callsPerSecond(f) / (1024.0 * 1024.0 * 1024.0);
+    printf("  %-12s %8.2f GB/s\n", name, gigabytes);
+}
+
+// Prints the time of one operation in nanoseconds, f performs count operations.
+template <typename F>
+void measureOperations(const char* name, size_t count, F&& f)
+{
+    const double nanoseconds = 1e9 / (static_cast<double>(count) * callsPerSecond(f));
+    printf("  %-12s %8.2f ns\n", name, nanoseconds);
+}
+
+std::vector<unsigned char> randomBytes(size_t size)
+{
+    std::mt19937 random(12345);
+    std::vector<unsigned char> data(size);
+    for (auto& byte : data) {
+        byte = static_cast<unsigned char>(random());
+    }
+    return data;
+}
+
+// The levels up to the one supported by the processor.
+std::vector<SimdLevel> getSupportedLevels()
+{
+    std::vector<SimdLevel> levels { SimdLevel::SCALAR };
+    for (auto level : { SimdLevel::SSE2, SimdLevel::AVX2 }) {
+        if (level <= FbUtils::getSimdLevel()) {
+            levels.push_back(level);
+        }
+    }
+    return levels;
+}
+
+void runHex(size_t size)
+{
+    const auto data = randomBytes(size);
+    std::string output(FbUtils::hexEncodedSize(size), '\0');
+
+    printf("hex encoding of %zu bytes:\n", size);
+    // a nibble at a time into a new string, for comparison
+    measure("nibbles", size, [&data, size]() {
+        constexpr char digits[] = "0123456789ABCDEF";
+        std::string s;
+        s.reserve(size * 2);
+        for (const auto c : data) {
+            s.push_back(digits[c >> 4]);
+            s.push_back(digits[c & 15]);
+        }
+        if (s.size() != size * 2) {
+            throw std::logic_error("unexpected hex size");
+        }
+    });
+    for (const auto level : getSupportedLevels()) {
+        measure(FbUtils::getSimdLevelName(level), size, [&data, &output, size, level]() {
+            FbUtils::encodeHex(data.data(), size, output.data(), level);
+        });
+    }
+}
+
+void runBase64(size_t size)
+{
+    const auto data = randomBytes(size);
+    std::string output(FbUtils::base64EncodedSize(size), '\0');
+
+    printf("base64 encoding of %zu bytes:\n", size);
+    for (const auto level : { SimdLevel::SCALAR, SimdLevel::AVX2 }) {
+        if (level > FbUtils::getSimdLevel()) {
+            continue;
+        }
+        measure(FbUtils::getSimdLevelName(level), size, [&data, &output, size, level]() {
+            FbUtils::encodeBase64(data.data(), size, output.data(), level);
+        });
+    }
+}
+
+void runConverters(size_t count)
+{
+    auto master = fb_get_master_interface();
+    ThrowStatusWrapper status(master->getStatus());
+    MockEncodeUtils encodeUtils;
+    const StringEncodeHelper encoder(&encodeUtils);
+
+    // character sets of text fields in the order they are converted
+    std::mt19937 random(12345);
+    std::vector<unsigned> charsetIds(count);
+    for (auto& charsetId : charsetIds) {
+        charsetId = (random() % 4 == 0) ? CS_ISO8859_1 : CS_WIN1251;
+    }
+
+    printf("converter lookup per field, %zu fields:\n", count);
+    // the former cache of the plugin: a tree with a lazily constructed value
+    std::map<unsigned, StringConverterHelper> converterMap;
+    measureOperations("std::map", count, [&]() {
+        uintptr_t sum = 0;
+        for (const auto charsetId : charsetIds) {
+            auto [it, result] = converterMap.try_emplace(
+                charsetId,
+                lazy_convert_construct([charsetId, &status, &encoder] {
+                    return encoder.getConverterById(&status, charsetId);
+                }));
+            sum += reinterpret_cast<uintptr_t>(&it->second);
+        }
+        if (sum == 0) {
+            throw std::logic_error("unexpected converter");
+        }
+    });
+    StringConverterCache converterCache(encoder);
+    measureOperations("array", count, [&]() {
+        uintptr_t sum = 0;
+        for (const auto charsetId : charsetIds) {
+            sum += reinterpret_cast<uintptr_t>(&converterCache.get(&status, charsetId));
+        }
+        if (sum == 0) {
+            throw std::logic_error("unexpected converter");
+        }
+    });
+    status.dispose();
+}
+
+// records of 150 fields prepared for the layout check
+constexpr unsigned LAYOUT_FIELD_COUNT = 150;
+constexpr unsigned LAYOUT_RECORD_COUNT = 64;
+
+void runLayouts(size_t count)
+{
+    // records of the same format, each with field objects of its own
+    std::vector<std::unique_ptr<MockRecord>> records;
+    for (unsigned r = 0; r < LAYOUT_RECORD_COUNT; r++) {
+        auto record = std::make_unique<MockRecord>();
+        for (unsigned i = 0; i < LAYOUT_FIELD_COUNT; i++) {
+            const auto name = "FIELD_" + std::to_string(i + 1);
+            if (i % 3 == 0)
+                record->addField(name, SQL_VARYING, 0, 0, 40, CS_UTF8);
+            else
+                record->addField(name, SQL_LONG, 0, 0, sizeof(ISC_LONG), CS_NONE);
+        }
+        records.push_back(std::move(record));
+    }
+
+    RecordLayout layout;
+    layout.fieldCount = LAYOUT_FIELD_COUNT;
+    layout.rawLength = records[0]->getRawLength();
+    for (unsigned i = 0; i < LAYOUT_FIELD_COUNT; i++) {
+        layout.signature.push_back(SimpleJsonPlugin::getFieldSignature(records[0]->getField(i)));
+    }
+
+    printf("record layout check of %u fields, %zu records:\n", LAYOUT_FIELD_COUNT, count);
+    const auto check = [&layout, &records, count](size_t recordCount) {
+        size_t matched = 0;
+        for (size_t i = 0; i < count; i++) {
+            matched += layout.matches(records[i % recordCount].get()) ? 1 : 0;
+        }
+        if (matched != count) {
+            throw std::logic_error("unexpected layout mismatch");
+        }
+    };
+    // the host passes the same field objects again
+    measureOperations("same fields", count, [&check]() { check(1); });
+    // every record has other field objects
+    measureOperations("new fields", count, [&check]() { check(LAYOUT_RECORD_COUNT); });
+}
+
+struct MicroBenchmark {
+    const char* name;
+    void (*run)(size_t size);
+};
+
+const MicroBenchmark microBenchmarks[] = {
+    { "hex", runHex },
+    { "base64", runBase64 },
+    { "converters", runConverters },
+    { "layouts", runLayouts }
+};
+
+} // namespace
+
+namespace SimpleJsonBenchmark {
+
+std::string getMicroBenchmarkNames()
+{
+    std::string names;
+    for (const auto& benchmark : microBenchmarks) {
+        if (!names.empty()) {
+            names += ", ";
+        }
+        names += benchmark.name;
+    }
+    return names;
+}
+
+void runMicroBenchmark(const std::string& name, size_t size)
+{
+    for (const auto& benchmark : microBenchmarks) {
+        if (name == benchmark.name) {
+            printf("processor: %s\n", FbUtils::getSimdLevelName(FbUtils::getSimdLevel()));
+            benchmark.run(size);
+            return;
+        }
+    }
+    throw std::invalid_argument("unknown micro benchmark: " + name);
+}
+
+} // namespace SimpleJsonBenchmark
@@ -0,0 +1,20 @@
+#pragma once
+#ifndef SIMPLE_JSON_BENCHMARK_MICRO_BENCHMARKS_H
+#define SIMPLE_JSON_BENCHMARK_MICRO_BENCHMARKS_H
+
+#include <cstddef>
+#include <string>
+
+namespace SimpleJsonBenchmark {
+
+// Names of the available micro benchmarks separated by commas.
+std::string getMicroBenchmarkNames();
+
+// Measures the throughput of one building block of the plugin on a buffer of the given size
+// (the number of operations for the benchmarks that are not about buffers) and prints the results.
+// Throws std::invalid_argument if there is no such benchmark.
+void runMicroBenchmark(const std::string& name, size_t size);
+
+} // namespace SimpleJsonBenchmark
+
+#endif // SIMPLE_JSON_BENCHMARK_MICRO_BENCHMARKS_H
@@ -0,0 +1,534 @@
+#include "SegmentGenerator.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include "../../common/Utils.h"
+#include "../../common/charsets.h"
+
+using namespace Firebird;
+
+namespace {
+
+using SimpleJsonBenchmark::ColumnType;
+using SimpleJsonBenchmark::MockField;
+using SimpleJsonBenchmark::MockRecord;
+
+// time zone ids: GMT and the +03:00 offset
+constexpr ISC_USHORT TZ_GMT = 65535;
+constexpr ISC_USHORT TZ_PLUS_3 = 1439 + 180;
+
+constexpr ISC_TIME TIME_UNITS_PER_DAY = 86400u * 10000u;
+
+const char* const ASCII_WORDS[] = {
+    "alpha", "bravo", "charlie", "delta", "echo", "foxtrot", "golf", "hotel",
+    "india", "juliet", "kilo", "lima", "mike", "november", "oscar", "papa"
+};
+
+// "Привет", "мир", "данные", "поток" in UTF-8 and WIN1251
+const char* const UTF8_WORDS[] = {
+    "\xD0\x9F\xD1\x80\xD0\xB8\xD0\xB2\xD0\xB5\xD1\x82", "\xD0\xBC\xD0\xB8\xD1\x80",
+    "\xD0\xB4\xD0\xB0\xD0\xBD\xD0\xBD\xD1\x8B\xD0\xB5", "\xD0\xBF\xD0\xBE\xD1\x82\xD0\xBE\xD0\xBA"
+};
+const char* const WIN1251_WORDS[] = {
+    "\xCF\xF0\xE8\xE2\xE5\xF2", "\xEC\xE8\xF0", "\xE4\xE0\xED\xED\xFB\xE5", "\xEF\xEE\xF2\xEE\xEA"
+};
+
+struct TypeName {
+    const char* name;
+    ColumnType type;
+};
+
+const TypeName TYPE_NAMES[] = {
+    { "smallint", ColumnType::SMALLINT },
+    { "integer", ColumnType::INTEGER },
+    { "bigint", ColumnType::BIGINT },
+    { "numeric", ColumnType::NUMERIC },
+    { "int128", ColumnType::INT128 },
+    { "float", ColumnType::FLOAT },
+    { "double", ColumnType::DOUBLE },
+    { "decfloat16", ColumnType::DECFLOAT16 },
+    { "decfloat34", ColumnType::DECFLOAT34 },
+    { "char", ColumnType::CHAR },
+    { "varchar", ColumnType::VARCHAR },
+    { "varbinary", ColumnType::VARBINARY },
+    { "date", ColumnType::DATE },
+    { "time", ColumnType::TIME },
+    { "timestamp", ColumnType::TIMESTAMP },
+    { "time_tz", ColumnType::TIME_TZ },
+    { "timestamp_tz", ColumnType::TIMESTAMP_TZ },
+    { "boolean", ColumnType::BOOLEAN },
+    { "blob", ColumnType::BLOB }
+};
+
+struct CharsetName {
+    const char* name;
+    unsigned id;
+};
+
+const CharsetName CHARSET_NAMES[] = {
+    { "none", CS_NONE },
+    { "octets", CS_BINARY },
+    { "ascii", CS_ASCII },
+    { "utf8", CS_UTF8 },
+    { "win1251", CS_WIN1251 },
+    { "iso8859_1", CS_ISO8859_1 }
+};
+
+std::vector<std::string> splitList(const std::string& list)
+{
+    std::vector<std::string> items;
+    size_t start = 0;
+    while (start <= list.size()) {
+        auto end = list.find(',', start);
+        if (end == std::string::npos) {
+            end = list.size();
+        }
+        if (end > start) {
+            items.push_back(list.substr(start, end - start));
+        }
+        start = end + 1;
+    }
+    return items;
+}
+
+unsigned getMaxCharSize(unsigned charset)
+{
+    return (charset == CS_UTF8) ? 4 : 1;
+}
+
+// Text of about 3/4 of maxChars characters. Some values contain characters that must be escaped in JSON.
+std::string makeText(unsigned charset, unsigned maxChars, unsigned variant, unsigned column)
+{
+    std::string text;
+    const unsigned targetChars = maxChars - maxChars / 4 + (variant * 7 + column) % (maxChars / 4 + 1);
+    unsigned chars = 0;
+    unsigned word = variant + column;
+    while (chars < targetChars) {
+        std::string_view next;
+        unsigned nextChars = 0;
+        // every fourth word is Cyrillic if the character set allows it
+        if (word % 4 == 3 && charset == CS_UTF8) {
+            next = UTF8_WORDS[word / 4 % std::size(UTF8_WORDS)];
+            nextChars = static_cast<unsigned>(next.size() / 2);
+        } else if (word % 4 == 3 && charset == CS_WIN1251) {
+            next = WIN1251_WORDS[word / 4 % std::size(WIN1251_WORDS)];
+            nextChars = static_cast<unsigned>(next.size());
+        } else {
+            next = ASCII_WORDS[word % std::size(ASCII_WORDS)];
+            nextChars = static_cast<unsigned>(next.size());
+        }
+        if (chars + nextChars + 1 > targetChars) {
+            break;
+        }
+        if (!text.empty()) {
+            text += ' ';
+            chars++;
+        }
+        text += next;
+        chars += nextChars;
+        word += 5;
+    }
+    if (variant % 16 == 0 && chars + 3 <= maxChars) {
+        text += "\"\\\t";
+    }
+    return text;
+}
+
+std::string makeBytes(unsigned length, unsigned variant, unsigned column)
+{
+    std::string bytes(length, '\0');
+    unsigned value = variant * 2654435761u + column;
+    for (auto& b : bytes) {
+        value = value * 1103515245u + 12345u;
+        b = static_cast<char>(value >> 24);
+    }
+    return bytes;
+}
+
+void addColumn(MockRecord& record, ColumnType type, unsigned charset, unsigned textLength, unsigned column)
+{
+    const auto name = FbUtils::vformat("F%u", column + 1);
+    switch (type) {
+    case ColumnType::SMALLINT:
+        record.addField(name, SQL_SHORT, 0, 0, sizeof(ISC_SHORT), CS_NONE);
+        break;
+    case ColumnType::INTEGER:
+        record.addField(name, SQL_LONG, 0, 0, sizeof(ISC_LONG), CS_NONE);
+        break;
+    case ColumnType::BIGINT:
+        record.addField(name, SQL_INT64, 0, 0, sizeof(ISC_INT64), CS_NONE);
+        break;
+    case ColumnType::NUMERIC:
+        record.addField(name, SQL_INT64, 1, -2, sizeof(ISC_INT64), CS_NONE);
+        break;
+    case ColumnType::INT128:
+        record.addField(name, SQL_INT128, 1, -4, sizeof(FB_I128), CS_NONE);
+        break;
+    case ColumnType::FLOAT:
+        record.addField(name, SQL_FLOAT, 0, 0, sizeof(float), CS_NONE);
+        break;
+    case ColumnType::DOUBLE:
+        record.addField(name, SQL_DOUBLE, 0, 0, sizeof(double), CS_NONE);
+        break;
+    case ColumnType::DECFLOAT16:
+        record.addField(name, SQL_DEC16, 0, 0, sizeof(FB_DEC16), CS_NONE);
+        break;
+    case ColumnType::DECFLOAT34:
+        record.addField(name, SQL_DEC34, 0, 0, sizeof(FB_DEC34), CS_NONE);
+        break;
+    case ColumnType::CHAR:
+        record.addField(name, SQL_TEXT, 0, 0, textLength * getMaxCharSize(charset), charset);
+        break;
+    case ColumnType::VARCHAR:
+        record.addField(name, SQL_VARYING, 0, 0, textLength * getMaxCharSize(charset), charset);
+        break;
+    case ColumnType::VARBINARY:
+        record.addField(name, SQL_VARYING, 0, 0, textLength, CS_BINARY);
+        break;
+    case ColumnType::DATE:
+        record.addField(name, SQL_TYPE_DATE, 0, 0, sizeof(ISC_DATE), CS_NONE);
+        break;
+    case ColumnType::TIME:
+        record.addField(name, SQL_TYPE_TIME, 0, 0, sizeof(ISC_TIME), CS_NONE);
+        break;
+    case ColumnType::TIMESTAMP:
+        record.addField(name, SQL_TIMESTAMP, 0, 0, sizeof(ISC_TIMESTAMP), CS_NONE);
+        break;
+    case ColumnType::TIME_TZ:
+        record.addField(name, SQL_TIME_TZ, 0, 0, sizeof(ISC_TIME_TZ), CS_NONE);
+        break;
+    case ColumnType::TIMESTAMP_TZ:
+        record.addField(name, SQL_TIMESTAMP_TZ, 0, 0, sizeof(ISC_TIMESTAMP_TZ), CS_NONE);
+        break;
+    case ColumnType::BOOLEAN:
+        record.addField(name, SQL_BOOLEAN, 0, 0, sizeof(FB_BOOLEAN), CS_NONE);
+        break;
+    case ColumnType::BLOB:
+        record.addField(name, SQL_BLOB, 1, 0, sizeof(ISC_QUAD), charset);
+        break;
+    }
+}
+
+template <typename T>
+void setValue(MockField& field, const T& value)
+{
+    field.setData(&value, sizeof(value));
+}
+
+void fillColumn(MockField& field, ColumnType type, unsigned textLength, unsigned table, unsigned variant, unsigned column)
+{
+    // every column except the first one is sometimes NULL
+    if (column > 0 && (variant + column) % 11 == 0) {
+        field.setNull(true);
+        return;
+    }
+    const auto v = static_cast<int64_t>(variant);
+    switch (type) {
+    case ColumnType::SMALLINT:
+        setValue(field, static_cast<ISC_SHORT>(v * 37 - 1000));
+        break;
+    case ColumnType::INTEGER:
+        setValue(field, static_cast<ISC_LONG>(v * 7919 - 50000));
+        break;
+    case ColumnType::BIGINT:
+        setValue(field, static_cast<ISC_INT64>((v + 1) * 1234567891011LL * ((v % 2) ? -1 : 1)));
+        break;
+    case ColumnType::NUMERIC:
+        setValue(field, static_cast<ISC_INT64>(v * 100003 - 3000000));
+        break;
+    case ColumnType::INT128: {
+        const auto value = static_cast<ISC_INT64>(v * 98765432109LL - 3000000000000LL);
+        FB_I128 i128 {};
+        i128.fb_data[0] = static_cast<ISC_UINT64>(value);
+        i128.fb_data[1] = (value < 0) ? ~0ULL : 0;
+        setValue(field, i128);
+        break;
+    }
+    case ColumnType::FLOAT:
+        setValue(field, static_cast<float>(v) * 0.37f);
+        break;
+    case ColumnType::DOUBLE:
+        setValue(field, 1000.0 / static_cast<double>(v + 3));
+        break;
+    case ColumnType::DECFLOAT16: {
+        // exponent 0, any declet is a valid coefficient
+        FB_DEC16 dec16 {};
+        dec16.fb_data[0] = 0x2238000000000000ULL | (variant * 37 % 1024);
+        setValue(field, dec16);
+        break;
+    }
+    case ColumnType::DECFLOAT34: {
+        FB_DEC34 dec34 {};
+        dec34.fb_data[0] = variant * 37 % 1024;
+        dec34.fb_data[1] = 0x2208000000000000ULL;
+        setValue(field, dec34);
+        break;
+    }
+    case ColumnType::CHAR: {
+        const auto charset = field.getCharSet();
+        std::string text = (charset == CS_BINARY) ? makeBytes(field.getLength(), variant, column)
+                                                  : makeText(charset, textLength, variant, column);
+        text.resize(field.getLength(), ' ');
+        field.setData(text.data(), text.size());
+        break;
+    }
+    case ColumnType::VARCHAR:
+    case ColumnType::VARBINARY: {
+        const auto charset = field.getCharSet();
+        const std::string text = (charset == CS_BINARY) ? makeBytes(field.getLength() - variant % (field.getLength() / 2 + 1), variant, column)
+                                                        : makeText(charset, textLength, variant, column);
+        auto buffer = field.getBuffer();
+        const auto length = static_cast<ISC_USHORT>(text.size());
+        memcpy(buffer, &length, sizeof(length));
+        memcpy(buffer + sizeof(length), text.data(), text.size());
+        field.setNull(false);
+        break;
+    }
+    case ColumnType::DATE:
+        setValue(field, static_cast<ISC_DATE>(58000 + v * 13));
+        break;
+    case ColumnType::TIME:
+        setValue(field, static_cast<ISC_TIME>((variant * 3600u * 10000u / 7 + 1234u) % TIME_UNITS_PER_DAY));
+        break;
+    case ColumnType::TIMESTAMP: {
+        ISC_TIMESTAMP ts {};
+        ts.timestamp_date = static_cast<ISC_DATE>(60000 + v);
+        ts.timestamp_time = (variant * 5393u * 10000u + 4321u) % TIME_UNITS_PER_DAY;
+        setValue(field, ts);
+        break;
+    }
+    case ColumnType::TIME_TZ: {
+        ISC_TIME_TZ timeTz {};
+        timeTz.utc_time = (variant * 3600u * 10000u / 5 + 77u) % TIME_UNITS_PER_DAY;
+        timeTz.time_zone = (variant % 2) ? TZ_PLUS_3 : TZ_GMT;
+        setValue(field, timeTz);
+        break;
+    }
+    case ColumnType::TIMESTAMP_TZ: {
+        ISC_TIMESTAMP_TZ tsTz {};
+        tsTz.utc_timestamp.timestamp_date = static_cast<ISC_DATE>(60000 + v);
+        tsTz.utc_timestamp.timestamp_time = (variant * 4099u * 10000u + 99u) % TIME_UNITS_PER_DAY;
+        tsTz.time_zone = (variant % 2) ? TZ_PLUS_3 : TZ_GMT;
+        setValue(field, tsTz);
+        break;
+    }
+    case ColumnType::BOOLEAN:
+        setValue(field, static_cast<FB_BOOLEAN>(variant % 2));
+        break;
+    case ColumnType::BLOB: {
+        ISC_QUAD blobId {};
+        blobId.gds_quad_high = static_cast<ISC_LONG>(table + 1);
+        blobId.gds_quad_low = variant * 1024 + column;
+        setValue(field, blobId);
+        break;
+    }
+    }
+}
+
+} // namespace
+
+namespace SimpleJsonBenchmark {
+
+std::vector<ColumnType> parseColumnTypes(const std::string& list)
+{
+    std::vector<ColumnType> types;
+    for (const auto& item : splitList(list)) {
+        const auto it = std::find_if(std::begin(TYPE_NAMES), std::end(TYPE_NAMES), [&item](const TypeName& t) {
+            return item == t.name;
+        });
+        if (it == std::end(TYPE_NAMES)) {
+            FbUtils::raiseError(R"(Unknown column type "%s")", item.c_str());
+        }
+        types.push_back(it->type);
+    }
+    if (types.empty()) {
+        FbUtils::raiseError("The list of column types is empty");
+    }
+    return types;
+}
+
+std::vector<unsigned> parseCharsets(const std::string& list)
+{
+    std::vector<unsigned> charsets;
+    for (const auto& item : splitList(list)) {
+        const auto it = std::find_if(std::begin(CHARSET_NAMES), std::end(CHARSET_NAMES), [&item](const CharsetName& c) {
+            return item == c.name;
+        });
+        if (it == std::end(CHARSET_NAMES)) {
+            FbUtils::raiseError(R"(Unknown character set "%s")", item.c_str());
+        }
+        charsets.push_back(it->id);
+    }
+    if (charsets.empty()) {
+        FbUtils::raiseError("The list of character sets is empty");
+    }
+    return charsets;
+}
+
+struct SegmentGenerator::Table {
+    std::string name;
+    std::vector<ColumnType> columnTypes;
+    std::vector<std::unique_ptr<MockRecord>> variants;
+    // indexes of BLOB columns
+    std::vector<unsigned> blobColumns;
+};
+
+SegmentGenerator::SegmentGenerator(const GeneratorOptions& options)
+    : m_options(options)
+    , m_tables()
+    , m_blob()
+    , m_openTransactions()
+    , m_nextTransaction(1)
+    , m_statistics()
+{
+}
+
+SegmentGenerator::~SegmentGenerator() = default;
+
+void SegmentGenerator::prepare()
+{
+    m_tables.clear();
+    unsigned textColumn = 0;
+    for (unsigned t = 0; t < m_options.tables; t++) {
+        auto table = std::make_unique<Table>();
+        table->name = FbUtils::vformat("TABLE_%u", t + 1);
+        std::vector<unsigned> charsets;
+        // tables start at different positions of the type list, so they differ from each other
+        for (unsigned c = 0; c < m_options.tableWidth; c++) {
+            const auto type = m_options.columnTypes[(t + c) % m_options.columnTypes.size()];
+            table->columnTypes.push_back(type);
+            unsigned charset = CS_NONE;
+            if (type == ColumnType::CHAR || type == ColumnType::VARCHAR || type == ColumnType::BLOB) {
+                charset = m_options.charsets[textColumn++ % m_options.charsets.size()];
+            }
+            charsets.push_back(charset);
+            if (type == ColumnType::BLOB) {
+                table->blobColumns.push_back(c);
+            }
+        }
+        for (unsigned v = 0; v < m_options.recordVariants; v++) {
+            auto record = std::make_unique<MockRecord>();
+            for (unsigned c = 0; c < m_options.tableWidth; c++) {
+                addColumn(*record, table->columnTypes[c], charsets[c], m_options.textLength, c);
+                fillColumn(record->field(c), table->columnTypes[c], m_options.textLength, t, v, c);
+            }
+            table->variants.push_back(std::move(record));
+        }
+        m_tables.push_back(std::move(table));
+    }
+
+    m_blob.resize(m_options.blobSize);
+    for (size_t i = 0; i < m_blob.size(); i++) {
+        // printable text, so that text blobs are valid in any character set
+        m_blob[i] = static_cast<unsigned char>('a' + i % 26);
+    }
+}
+
+void SegmentGenerator::run(ThrowStatusWrapper* status, IStreamPlugin* plugin)
+{
+    m_statistics = GeneratorStatistics();
+    m_openTransactions.assign(std::max(m_options.transactions, 1u), OpenTransaction());
+
+    for (unsigned s = 0; s < m_options.segments; s++) {
+        SegmentHeaderInfo header {};
+        snprintf(header.name, sizeof(header.name), "bench.%u", s + 1);
+        snprintf(header.guid, sizeof(header.guid), "{7D3A2C5E-1B4F-4E8A-9C6D-0F2E8B7A5D31}");
+        header.version = 1;
+        header.sequence = s + 1;
+        header.state = 3;
+        header.length = 0;
+
+        plugin->startSegment(status, &header);
+        for (uint64_t i = 0; i < m_options.recordsPerSegment; i++) {
+            auto& tnx = m_openTransactions[i % m_openTransactions.size()];
+            if (!tnx.transaction) {
+                tnx.number = m_nextTransaction++;
+                tnx.transaction = plugin->startTransaction(status, tnx.number);
+                tnx.records = 0;
+                m_statistics.transactionEvents++;
+            }
+            if (i * 13 % 100 < m_options.savepointPercent) {
+                runSavepoint(status, plugin, tnx, i);
+            } else {
+                runRecordEvent(status, plugin, tnx, i);
+            }
+            if (++tnx.records >= m_options.transactionSize) {
+                endTransaction(status, plugin, tnx);
+            }
+        }
+        // transactions may continue in the next segment
+        if (s + 1 == m_options.segments) {
+            for (auto& tnx : m_openTransactions) {
+                if (tnx.transaction) {
+                    endTransaction(status, plugin, tnx);
+                }
+            }
+        }
+        plugin->finishSegment(status);
+    }
+}
+
+void SegmentGenerator::runRecordEvent(ThrowStatusWrapper* status, IStreamPlugin* plugin, OpenTransaction& tnx, uint64_t eventNumber)
+{
+    auto& table = *m_tables[eventNumber % m_tables.size()];
+    if (!plugin->matchTable(status, table.name.c_str())) {
+        return;
+    }
+    const auto variant = static_cast<unsigned>(eventNumber / m_tables.size() % m_options.recordVariants);
+    auto record = table.variants[variant].get();
+
+    const auto share = static_cast<unsigned>(eventNumber * 7 % 100);
+    if (share < m_options.updatePercent) {
+        auto newRecord = table.variants[(variant + 1) % m_options.recordVariants].get();
+        tnx.transaction->updateRecord(status, table.name.c_str(), record, newRecord);
+    } else if (share < m_options.updatePercent + m_options.deletePercent) {
+        tnx.transaction->deleteRecord(status, table.name.c_str(), record);
+    } else {
+        if (!m_blob.empty()) {
+            // blobs are passed before the record that refers to them
+            for (const auto column : table.blobColumns) {
+                auto field = record->getField(column);
+                if (auto data = field->getData()) {
+                    ISC_QUAD blobId;
+                    memcpy(&blobId, data, sizeof(blobId));
+                    tnx.transaction->storeBlob(status, &blobId, static_cast<ISC_INT64>(m_blob.size()), m_blob.data());
+                    m_statistics.blobEvents++;
+                }
+            }
+        }
+        tnx.transaction->insertRecord(status, table.name.c_str(), record);
+    }
+    m_statistics.recordEvents++;
+}
+
+void SegmentGenerator::runSavepoint(ThrowStatusWrapper* status, IStreamPlugin* plugin, OpenTransaction& tnx, uint64_t eventNumber)
+{
+    tnx.transaction->startSavepoint(status);
+    runRecordEvent(status, plugin, tnx, eventNumber);
+    if (eventNumber % 2 == 0) {
+        tnx.transaction->releaseSavepoint(status);
+    } else {
+        tnx.transaction->rollbackSavepoint(status);
+    }
+    m_statistics.transactionEvents += 2;
+}
+
+void SegmentGenerator::endTransaction(ThrowStatusWrapper* status, IStreamPlugin* plugin, OpenTransaction& tnx)
+{
+    if (static_cast<uint64_t>(tnx.number) * 37 % 100 < m_options.rollbackPercent) {
+        tnx.transaction->rollback(status);
+        m_statistics.transactionEvents++;
+    } else {
+        tnx.transaction->prepare(status);
+        tnx.transaction->commit(status);
+        // prepare and commit
+        m_statistics.transactionEvents += 2;
+    }
+    plugin->cleanupTransaction(status, tnx.number);
+    tnx.transaction->dispose();
+    tnx.transaction = nullptr;
+}
+
+} // namespace SimpleJsonBenchmark
@@ -0,0 +1,118 @@
+#pragma once
+#ifndef SIMPLE_JSON_BENCHMARK_SEGMENT_GENERATOR_H
+#define SIMPLE_JSON_BENCHMARK_SEGMENT_GENERATOR_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../../include/StreamingInterface.h"
+#include "BenchmarkMocks.h"
+
+namespace SimpleJsonBenchmark {
+
+enum class ColumnType {
+    SMALLINT,
+    INTEGER,
+    BIGINT,
+    NUMERIC, // BIGINT with scale 2
+    INT128, // INT128 with scale 4
+    FLOAT,
+    DOUBLE,
+    DECFLOAT16,
+    DECFLOAT34,
+    CHAR,
+    VARCHAR,
+    VARBINARY,
+    DATE,
+    TIME,
+    TIMESTAMP,
+    TIME_TZ,
+    TIMESTAMP_TZ,
+    BOOLEAN,
+    BLOB
+};
+
+// Parses a comma separated list of column types, e.g. "integer,varchar,timestamp".
+std::vector<ColumnType> parseColumnTypes(const std::string& list);
+// Parses a comma separated list of character sets, e.g. "utf8,win1251".
+std::vector<unsigned> parseCharsets(const std::string& list);
+
+struct GeneratorOptions {
+    unsigned segments = 10;
+    unsigned recordsPerSegment = 100000;
+    unsigned tables = 4;
+    // number of columns in each table
+    unsigned tableWidth = 16;
+    // column types are taken from the list one by one
+    std::vector<ColumnType> columnTypes;
+    // character sets of text columns are taken from the list one by one
+    std::vector<unsigned> charsets;
+    // maximum length of text columns in characters
+    unsigned textLength = 40;
+    // if not 0, a blob of this size is stored for every BLOB column of inserted records
+    unsigned blobSize = 0;
+    // number of transactions open at the same time, their events are interleaved
+    unsigned transactions = 4;
+    // number of records changed by a transaction before it commits
+    unsigned transactionSize = 100;
+    // shares of update and delete events in percent, the rest are inserts
+    unsigned updatePercent = 0;
+    unsigned deletePercent = 0;
+    // share of transactions rolled back instead of committed in percent
+    unsigned rollbackPercent = 0;
+    // share of record events made under a savepoint in percent, every other one is rolled back
+    unsigned savepointPercent = 0;
+    // number of distinct records prepared for each table, each has field objects of its own
+    unsigned recordVariants = 64;
+};
+
+struct GeneratorStatistics {
+    uint64_t recordEvents = 0;
+    uint64_t transactionEvents = 0;
+    uint64_t blobEvents = 0;
+
+    uint64_t events() const { return recordEvents + transactionEvents + blobEvents; }
+};
+
+// Generates synthetic segments and passes their events to a stream plugin
+// the same way fb_streaming does.
+class SegmentGenerator final {
+public:
+    explicit SegmentGenerator(const GeneratorOptions& options);
+    ~SegmentGenerator();
+
+    SegmentGenerator(const SegmentGenerator&) = delete;
+    SegmentGenerator& operator=(const SegmentGenerator&) = delete;
+
+    // Records are prepared in advance, so that their generation is not measured.
+    void prepare();
+    void run(Firebird::ThrowStatusWrapper* status, Firebird::IStreamPlugin* plugin);
+
+    const GeneratorStatistics& getStatistics() const { return m_statistics; }
+
+private:
+    struct Table;
+    struct OpenTransaction {
+        ISC_INT64 number = 0;
+        Firebird::IStreamedTransaction* transaction = nullptr;
+        unsigned records = 0;
+    };
+
+    void runRecordEvent(Firebird::ThrowStatusWrapper* status, Firebird::IStreamPlugin* plugin, OpenTransaction& tnx, uint64_t eventNumber);
+    void runSavepoint(Firebird::ThrowStatusWrapper* status, Firebird::IStreamPlugin* plugin, OpenTransaction& tnx, uint64_t eventNumber);
+    // Commits the transaction or rolls it back, as rollbackPercent says.
+    void endTransaction(Firebird::ThrowStatusWrapper* status, Firebird::IStreamPlugin* plugin, OpenTransaction& tnx);
+
+    const GeneratorOptions m_options;
+    std::vector<std::unique_ptr<Table>> m_tables;
+    std::vector<unsigned char> m_blob;
+    std::vector<OpenTransaction> m_openTransactions;
+    ISC_INT64 m_nextTransaction = 1;
+    GeneratorStatistics m_statistics;
+};
+
+} // namespace SimpleJsonBenchmark
+
+#endif // SIMPLE_JSON_BENCHMARK_SEGMENT_GENERATOR_H
@@ -0,0 +1,260 @@
+// Throughput benchmark of the simple_json_plugin.
+// Synthetic segments are passed to the plugin in-process, without Firebird and fb_streaming.
+//
+// Usage: simple_json_benchmark [options] [parameter=value ...]
+// Parameters of the form name=value are passed to the plugin as its configuration.
+
+#ifdef _WINDOWS
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <string>
+
+#include "../../include/StreamingInterface.h"
+#include "../../plugins/simple_json/SimpleJsonPlugin.h"
+#include "BenchmarkMocks.h"
+#include "MicroBenchmarks.h"
+#include "SegmentGenerator.h"
+
+using namespace Firebird;
+using namespace SimpleJsonBenchmark;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const char* const DEFAULT_COLUMN_TYPES = "integer,bigint,numeric,varchar,varchar,timestamp,double,char,date,boolean";
+const char* const DEFAULT_CHARSETS = "utf8,win1251";
+constexpr size_t DEFAULT_MICRO_SIZE = 4 * 1024 * 1024;
+
+void printUsage()
+{
+    printf(
+        "Usage: simple_json_benchmark [options] [parameter=value ...]\n"
+        "\n"
+        "Options:\n"
+        "  --segments=N           number of segments (10)\n"
+        "  --records=N            record events per segment (100000)\n"
+        "  --tables=N             number of tables (4)\n"
+        "  --width=N              columns per table (16)\n"
+        "  --types=LIST           column types, used one by one (%s)\n"
+        "                         smallint, integer, bigint, numeric, int128, float, double,\n"
+        "                         decfloat16, decfloat34, char, varchar, varbinary, date, time,\n"
+        "                         timestamp, time_tz, timestamp_tz, boolean, blob\n"
+        "  --charsets=LIST        character sets of text columns (%s)\n"
+        "                         none, octets, ascii, utf8, win1251, iso8859_1\n"
+        "  --text-length=N        maximum length of text columns in characters (40)\n"
+        "  --blob-size=N          size of blobs stored for BLOB columns, 0 - no blobs (0)\n"
+        "  --transactions=N       transactions with interleaved events (4)\n"
+        "  --transaction-size=N   records per transaction (100)\n"
+        "  --updates=P            percent of update events (0)\n"
+        "  --deletes=P            percent of delete events (0)\n"
+        "  --rollbacks=P          percent of transactions rolled back instead of committed (0)\n"
+        "  --savepoints=P         percent of record events under a savepoint,\n"
+        "                         every other savepoint is rolled back (0)\n"
+        "  --record-variants=N    distinct records prepared for each table, each with\n"
+        "                         field objects of its own (64)\n"
+        "  --output=DIR           directory for output files, cleared before the run\n"
+        "                         (simple_json_benchmark in the temporary directory)\n"
+        "  --micro=NAME           run a micro benchmark instead of segments (%s)\n"
+        "  --micro-size=N         buffer size of the micro benchmark in bytes,\n"
+        "                         number of lookups or checks for converters and layouts (%zu)\n"
+        "\n"
+        "Plugin parameters, e.g. outputFormat=ndjson asyncWrite=true, are passed as is.\n",
+        DEFAULT_COLUMN_TYPES, DEFAULT_CHARSETS, getMicroBenchmarkNames().c_str(), DEFAULT_MICRO_SIZE);
+}
+
+bool readOption(const std::string& arg, const char* name, std::string& value)
+{
+    const auto length = strlen(name);
+    if (arg.compare(0, length, name) != 0 || arg.size() <= length || arg[length] != '=') {
+        return false;
+    }
+    value = arg.substr(length + 1);
+    return true;
+}
+
+unsigned toUnsigned(const std::string& value)
+{
+    return static_cast<unsigned>(std::stoul(value));
+}
+
+uint64_t getOutputSize(const fs::path& directory)
+{
+    uint64_t size = 0;
+    for (const auto& entry : fs::recursive_directory_iterator(directory)) {
+        if (entry.is_regular_file()) {
+            size += entry.file_size();
+        }
+    }
+    return size;
+}
+
+// Peak resident set size of the process in bytes.
+uint64_t getPeakRss()
+{
+#ifdef _WINDOWS
+    PROCESS_MEMORY_COUNTERS counters {};
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.PeakWorkingSetSize;
+    }
+    return 0;
+#else
+    rusage usage {};
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return static_cast<uint64_t>(usage.ru_maxrss);
+#else
+    // kilobytes on Linux
+    return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    GeneratorOptions options;
+    std::string columnTypes = DEFAULT_COLUMN_TYPES;
+    std::string charsets = DEFAULT_CHARSETS;
+    fs::path outputDir = fs::temp_directory_path() / "simple_json_benchmark";
+    std::string microBenchmark;
+    size_t microSize = DEFAULT_MICRO_SIZE;
+
+    auto config = new MockConfig();
+    config->setValue("dumpBlobs", "true");
+
+    try {
+        for (int i = 1; i < argc; i++) {
+            const std::string arg = argv[i];
+            std::string value;
+            if (arg == "--help" || arg == "-h") {
+                printUsage();
+                config->release();
+                return 0;
+            } else if (readOption(arg, "--segments", value)) {
+                options.segments = toUnsigned(value);
+            } else if (readOption(arg, "--records", value)) {
+                options.recordsPerSegment = toUnsigned(value);
+            } else if (readOption(arg, "--tables", value)) {
+                options.tables = std::max(toUnsigned(value), 1u);
+            } else if (readOption(arg, "--width", value)) {
+                options.tableWidth = std::max(toUnsigned(value), 1u);
+            } else if (readOption(arg, "--types", value)) {
+                columnTypes = value;
+            } else if (readOption(arg, "--charsets", value)) {
+                charsets = value;
+            } else if (readOption(arg, "--text-length", value)) {
+                options.textLength = std::max(toUnsigned(value), 1u);
+            } else if (readOption(arg, "--blob-size", value)) {
+                options.blobSize = toUnsigned(value);
+            } else if (readOption(arg, "--transactions", value)) {
+                options.transactions = std::max(toUnsigned(value), 1u);
+            } else if (readOption(arg, "--transaction-size", value)) {
+                options.transactionSize = std::max(toUnsigned(value), 1u);
+            } else if (readOption(arg, "--updates", value)) {
+                options.updatePercent = toUnsigned(value);
+            } else if (readOption(arg, "--deletes", value)) {
+                options.deletePercent = toUnsigned(value);
+            } else if (readOption(arg, "--rollbacks", value)) {
+                options.rollbackPercent = toUnsigned(value);
+            } else if (readOption(arg, "--savepoints", value)) {
+                options.savepointPercent = toUnsigned(value);
+            } else if (readOption(arg, "--record-variants", value)) {
+                options.recordVariants = std::max(toUnsigned(value), 1u);
+            } else if (readOption(arg, "--output", value)) {
+                outputDir = value;
+            } else if (readOption(arg, "--micro", value)) {
+                microBenchmark = value;
+            } else if (readOption(arg, "--micro-size", value)) {
+                microSize = std::max<size_t>(std::stoull(value), 1);
+            } else if (const auto pos = arg.find('='); pos != std::string::npos && pos > 0 && arg[0] != '-') {
+                config->setValue(arg.substr(0, pos), arg.substr(pos + 1));
+            } else {
+                fprintf(stderr, "Unknown argument: %s\n\n", arg.c_str());
+                printUsage();
+                config->release();
+                return 1;
+            }
+        }
+        options.columnTypes = parseColumnTypes(columnTypes);
+        options.charsets = parseCharsets(charsets);
+    } catch (const std::exception& e) {
+        fprintf(stderr, "Invalid arguments: %s\n", e.what());
+        config->release();
+        return 1;
+    }
+
+    if (!microBenchmark.empty()) {
+        config->release();
+        try {
+            runMicroBenchmark(microBenchmark, microSize);
+        } catch (const std::exception& e) {
+            fprintf(stderr, "Error: %s\n", e.what());
+            return 1;
+        }
+        return 0;
+    }
+
+    // the plugin skips segments that already have output files
+    fs::remove_all(outputDir);
+    fs::create_directories(outputDir);
+    config->setValue("outputDir", outputDir.string());
+
+    auto master = fb_get_master_interface();
+    ThrowStatusWrapper status(master->getStatus());
+    MockLogger logger;
+    MockEncodeUtils encodeUtils;
+    int result = 0;
+    try {
+        SegmentGenerator generator(options);
+        generator.prepare();
+
+        SimpleJsonPlugin::SimpleJsonPluginFactory factory(master);
+        auto plugin = factory.createPlugin(&status, config, &encodeUtils, &logger);
+        plugin->init(&status, nullptr);
+
+        const auto start = std::chrono::steady_clock::now();
+        generator.run(&status, plugin);
+        // waits for the background writer, if it is used
+        plugin->finish(&status);
+        const auto finish = std::chrono::steady_clock::now();
+        plugin->release();
+
+        const double seconds = std::chrono::duration<double>(finish - start).count();
+        const auto& statistics = generator.getStatistics();
+        const auto outputSize = getOutputSize(outputDir);
+        const double megabytes = static_cast<double>(outputSize) / (1024.0 * 1024.0);
+
+        printf("segments:       %u\n", options.segments);
+        printf("record events:  %llu\n", static_cast<unsigned long long>(statistics.recordEvents));
+        printf("events:         %llu\n", static_cast<unsigned long long>(statistics.events()));
+        printf("time:           %.3f s\n", seconds);
+        printf("events/s:       %.0f\n", static_cast<double>(statistics.events()) / seconds);
+        printf("records/s:      %.0f\n", static_cast<double>(statistics.recordEvents) / seconds);
+        printf("output:         %.1f MB\n", megabytes);
+        printf("MB/s:           %.1f\n", megabytes / seconds);
+        printf("peak RSS:       %.1f MB\n", static_cast<double>(getPeakRss()) / (1024.0 * 1024.0));
+    } catch (const FbException& e) {
+        char message[1024];
+        master->getUtilInterface()->formatStatus(message, sizeof(message), e.getStatus());
+        fprintf(stderr, "Error: %s\n", message);
+        result = 1;
+    } catch (const std::exception& e) {
+        fprintf(stderr, "Error: %s\n", e.what());
+        result = 1;
+    }
+    config->release();
+    status.dispose();
+    return result;
+}
@@ -0,0 +1,210 @@
+#include "AsyncFileWriter.h"
+
+#include "Utils.h"
+
+namespace fs = std::filesystem;
+
+namespace FbUtils
+{
+
+    AsyncFileWriter::AsyncFileWriter(size_t queueSize, size_t chunkSize)
+        : m_tasks(queueSize)
+        , m_freeChunks(queueSize)
+        , m_chunk()
+        , m_chunkSize(chunkSize)
+        , m_file(nullptr)
+        , m_compressor(nullptr)
+        , m_skipFile(false)
+        , m_submitted(0)
+        , m_completed(0)
+        , m_stop(false)
+        , m_waitMutex()
+        , m_taskQueued()
+        , m_taskDone()
+        , m_failed(false)
+        , m_errorMutex()
+        , m_error()
+        , m_thread()
+    {
+        m_chunk.reserve(m_chunkSize);
+        m_thread = std::thread(&AsyncFileWriter::run, this);
+    }
+
+    AsyncFileWriter::~AsyncFileWriter()
+    {
+        // the writer thread processes all queued tasks before it stops
+        {
+            std::lock_guard<std::mutex> lock(m_waitMutex);
+            m_stop.store(true, std::memory_order_release);
+        }
+        m_taskQueued.notify_one();
+        m_thread.join();
+    }
+
+    void AsyncFileWriter::open(const fs::path& fileName, Compression compression, int compressionLevel)
+    {
+        // the rest of the abandoned file is not needed
+        m_chunk.clear();
+        Task task { Command::OPEN, fileName, {}, compression, compressionLevel };
+        submit(task);
+    }
+
+    void AsyncFileWriter::write(const char* data, size_t size)
+    {
+        if (!m_chunk.empty() && m_chunk.size() + size > m_chunkSize) {
+            flush();
+        }
+        m_chunk.append(data, size);
+    }
+
+    void AsyncFileWriter::flush()
+    {
+        if (m_chunk.empty()) {
+            return;
+        }
+        Task task { Command::WRITE, {}, std::move(m_chunk) };
+        submit(task);
+        if (!m_freeChunks.tryPop(m_chunk)) {
+            m_chunk = std::string();
+            m_chunk.reserve(m_chunkSize);
+        }
+    }
+
+    void AsyncFileWriter::close()
+    {
+        flush();
+        Task task { Command::CLOSE, {}, {} };
+        submit(task);
+    }
+
+    void AsyncFileWriter::closeAndRename(const fs::path& newName)
+    {
+        flush();
+        Task task { Command::CLOSE, newName, {} };
+        submit(task);
+    }
+
+    void AsyncFileWriter::wait()
+    {
+        flush();
+        {
+            std::unique_lock<std::mutex> lock(m_waitMutex);
+            m_taskDone.wait(lock, [this] {
+                return m_completed.load(std::memory_order_acquire) == m_submitted.load(std::memory_order_relaxed);
+            });
+        }
+        checkError();
+    }
+
+    void AsyncFileWriter::submit(Task& task)
+    {
+        checkError();
+        if (!m_tasks.tryPush(task)) {
+            // back-pressure: wait while the writer thread is behind
+            std::unique_lock<std::mutex> lock(m_waitMutex);
+            m_taskDone.wait(lock, [this, &task] { return m_tasks.tryPush(task); });
+        }
+        m_submitted.fetch_add(1, std::memory_order_relaxed);
+        // The writer thread checks the queue under the mutex before it waits,
+        // so taking the mutex here makes sure the notification is not lost.
+        // A task is a whole chunk, the cost per write is negligible.
+        {
+            std::lock_guard<std::mutex> lock(m_waitMutex);
+        }
+        m_taskQueued.notify_one();
+    }
+
+    void AsyncFileWriter::checkError()
+    {
+        if (!m_failed.load(std::memory_order_acquire)) {
+            return;
+        }
+        std::string message;
+        {
+            std::lock_guard<std::mutex> lock(m_errorMutex);
+            message = std::move(m_error);
+            m_error.clear();
+            m_failed.store(false, std::memory_order_relaxed);
+        }
+        raiseError("%s", message.c_str());
+    }
+
+    void AsyncFileWriter::run()
+    {
+        Task task;
+        for (;;) {
+            if (!m_tasks.tryPop(task)) {
+                std::unique_lock<std::mutex> lock(m_waitMutex);
+                m_taskQueued.wait(lock, [this] { return !m_tasks.empty() || m_stop.load(std::memory_order_acquire); });
+                if (m_tasks.empty()) {
+                    // stopped and everything is done
+                    break;
+                }
+                continue;
+            }
+            execute(task);
+            if (task.command == Command::WRITE) {
+                task.data.clear();
+                // if there is no room, the buffer is simply released
+                m_freeChunks.tryPush(task.data);
+            }
+            task.data = std::string();
+            {
+                // see submit() for why the mutex is taken
+                std::lock_guard<std::mutex> lock(m_waitMutex);
+                m_completed.fetch_add(1, std::memory_order_release);
+            }
+            m_taskDone.notify_one();
+        }
+        // an unfinished file is closed as is
+        m_compressor = nullptr;
+        m_file = nullptr;
+    }
+
+    void AsyncFileWriter::execute(Task& task)
+    {
+        try {
+            switch (task.command) {
+            case Command::OPEN:
+                m_compressor = nullptr;
+                m_file = nullptr;
+                m_skipFile = false;
+                // chunks are large enough, no extra buffering is needed
+                m_file = std::make_unique<BufferedFileWriter>(task.fileName, 0);
+                m_compressor = createCompressedStream(task.compression, task.compressionLevel, *m_file);
+                break;
+            case Command::WRITE:
+                if (m_file && !m_skipFile) {
+                    if (m_compressor)
+                        m_compressor->write(task.data);
+                    else
+                        m_file->write(task.data);
+                }
+                break;
+            case Command::CLOSE:
+                if (m_file && !m_skipFile) {
+                    if (m_compressor) {
+                        m_compressor->close();
+                        m_compressor = nullptr;
+                    }
+                    m_file->sync();
+                    m_file->close();
+                    const auto fileName = m_file->getFileName();
+                    m_file = nullptr;
+                    if (!task.fileName.empty()) {
+                        fs::rename(fileName, task.fileName);
+                    }
+                }
+                break;
+            }
+        } catch (const std::exception& e) {
+            m_compressor = nullptr;
+            m_file = nullptr;
+            m_skipFile = true;
+            std::lock_guard<std::mutex> lock(m_errorMutex);
+            m_error = e.what();
+            m_failed.store(true, std::memory_order_release);
+        }
+    }
+
+}
@@ -0,0 +1,110 @@
+#pragma once
+#ifndef FB_ASYNC_FILE_WRITER_H
+#define FB_ASYNC_FILE_WRITER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "BufferedFileWriter.h"
+#include "CompressedStream.h"
+#include "SpscQueue.h"
+
+namespace FbUtils
+{
+
+    // Writes files on a background thread.
+    // Data is collected into chunks on the caller's thread, full chunks are passed
+    // to the writer thread through a bounded queue. When the queue is full,
+    // the caller waits until the writer thread catches up. Both threads block on condition
+    // variables while they wait, an idle writer thread does not use the CPU.
+    // Errors of the writer thread are raised by the next call on the caller's thread.
+    class AsyncFileWriter final : public OutputStream
+    {
+    public:
+        static constexpr size_t DEFAULT_QUEUE_SIZE = 16;
+        static constexpr size_t DEFAULT_CHUNK_SIZE = 1024 * 1024;
+
+        explicit AsyncFileWriter(size_t queueSize = DEFAULT_QUEUE_SIZE, size_t chunkSize = DEFAULT_CHUNK_SIZE);
+        ~AsyncFileWriter() override;
+
+        AsyncFileWriter(const AsyncFileWriter&) = delete;
+        AsyncFileWriter& operator=(const AsyncFileWriter&) = delete;
+
+        // Starts a new file. The previous one, if it has not been closed, is abandoned.
+        // If compression is set, the data is compressed by the writer thread.
+        void open(const std::filesystem::path& fileName, Compression compression = Compression::NONE, int compressionLevel = 0);
+
+        void write(const char* data, size_t size) override;
+        // Passes the collected data to the writer thread.
+        void flush() override;
+        // Closes the current file after its data has been synced to disk.
+        // Like writes, the close is done by the writer thread, call wait() for its result.
+        void close() override;
+        // The same as close(), then renames the file to newName.
+        void closeAndRename(const std::filesystem::path& newName);
+
+        // Waits until the writer thread has processed everything passed to it
+        // and raises the error of the writer thread, if there is one.
+        void wait();
+
+        using OutputStream::write;
+
+    private:
+        enum class Command {
+            OPEN,
+            WRITE,
+            CLOSE
+        };
+
+        struct Task {
+            Command command = Command::WRITE;
+            // OPEN: the file to create; CLOSE: the new file name, if the file is to be renamed
+            std::filesystem::path fileName;
+            std::string data;
+            // OPEN only
+            Compression compression = Compression::NONE;
+            int compressionLevel = 0;
+        };
+
+        void submit(Task& task);
+        void checkError();
+        void run();
+        void execute(Task& task);
+
+        SpscQueue<Task> m_tasks;
+        // buffers of written chunks go back to the caller's thread for reuse
+        SpscQueue<std::string> m_freeChunks;
+        std::string m_chunk;
+        const size_t m_chunkSize;
+
+        std::unique_ptr<BufferedFileWriter> m_file;
+        // compresses into m_file, if compression is used
+        std::unique_ptr<OutputStream> m_compressor;
+        // after an error the writer thread skips everything up to the next file
+        bool m_skipFile = false;
+
+        std::atomic<uint64_t> m_submitted = 0;
+        std::atomic<uint64_t> m_completed = 0;
+        std::atomic_bool m_stop = false;
+        // the queues are lock-free, the mutex only guards the transitions the threads wait for
+        std::mutex m_waitMutex;
+        // a task has been queued or the writer thread is to stop
+        std::condition_variable m_taskQueued;
+        // a task has been done, so there is room in the queue
+        std::condition_variable m_taskDone;
+        std::atomic_bool m_failed = false;
+        std::mutex m_errorMutex;
+        std::string m_error;
+
+        std::thread m_thread;
+    };
+
+}
+
+#endif // FB_ASYNC_FILE_WRITER_H
@@ -0,0 +1,267 @@
+#include "BinaryEncoding.h"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define FB_BINARY_ENCODING_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define FB_TARGET_AVX2
+#else
+#define FB_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace {
+
+using FbUtils::SimdLevel;
+
+// Pairs of hex digits for every byte value.
+constexpr std::array<std::array<char, 2>, 256> makeHexPairs()
+{
+    constexpr char digits[] = "0123456789ABCDEF";
+    std::array<std::array<char, 2>, 256> pairs {};
+    for (unsigned i = 0; i < 256; i++) {
+        pairs[i] = { digits[i >> 4], digits[i & 15] };
+    }
+    return pairs;
+}
+
+constexpr auto hexPairs = makeHexPairs();
+
+char* encodeHexScalar(const unsigned char* data, size_t size, char* out) noexcept
+{
+    for (const auto end = data + size; data < end; ++data) {
+        memcpy(out, hexPairs[*data].data(), 2);
+        out += 2;
+    }
+    return out;
+}
+
+constexpr char base64Alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+char* encodeBase64Scalar(const unsigned char* data, size_t size, char* out) noexcept
+{
+    size_t pos = 0;
+    for (; pos + 3 <= size; pos += 3) {
+        const uint32_t triple = (uint32_t(data[pos]) << 16) | (uint32_t(data[pos + 1]) << 8) | data[pos + 2];
+        out[0] = base64Alphabet[triple >> 18];
+        out[1] = base64Alphabet[(triple >> 12) & 63];
+        out[2] = base64Alphabet[(triple >> 6) & 63];
+        out[3] = base64Alphabet[triple & 63];
+        out += 4;
+    }
+    if (pos < size) {
+        const uint32_t first = data[pos];
+        const uint32_t second = (pos + 1 < size) ? data[pos + 1] : 0;
+        out[0] = base64Alphabet[first >> 2];
+        out[1] = base64Alphabet[((first & 3) << 4) | (second >> 4)];
+        out[2] = (pos + 1 < size) ? base64Alphabet[(second & 15) << 2] : '=';
+        out[3] = '=';
+        out += 4;
+    }
+    return out;
+}
+
+#ifdef FB_BINARY_ENCODING_X86
+
+// Converts nibbles 0..15 to '0'..'9', 'A'..'F'.
+inline __m128i nibblesToHex(__m128i nibbles)
+{
+    // 'A' - '0' - 10
+    const auto letters = _mm_and_si128(_mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9)), _mm_set1_epi8(7));
+    return _mm_add_epi8(_mm_add_epi8(nibbles, _mm_set1_epi8('0')), letters);
+}
+
+char* encodeHexSse2(const unsigned char* data, size_t size, char* out) noexcept
+{
+    const auto lowMask = _mm_set1_epi8(0x0F);
+    size_t pos = 0;
+    for (; pos + 16 <= size; pos += 16) {
+        const auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+        const auto high = nibblesToHex(_mm_and_si128(_mm_srli_epi16(bytes, 4), lowMask));
+        const auto low = nibblesToHex(_mm_and_si128(bytes, lowMask));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi8(high, low));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16), _mm_unpackhi_epi8(high, low));
+        out += 32;
+    }
+    return encodeHexScalar(data + pos, size - pos, out);
+}
+
+FB_TARGET_AVX2 inline __m256i nibblesToHexAvx2(__m256i nibbles)
+{
+    const auto letters = _mm256_and_si256(_mm256_cmpgt_epi8(nibbles, _mm256_set1_epi8(9)), _mm256_set1_epi8(7));
+    return _mm256_add_epi8(_mm256_add_epi8(nibbles, _mm256_set1_epi8('0')), letters);
+}
+
+FB_TARGET_AVX2 char* encodeHexAvx2(const unsigned char* data, size_t size, char* out) noexcept
+{
+    const auto lowMask = _mm256_set1_epi8(0x0F);
+    size_t pos = 0;
+    for (; pos + 32 <= size; pos += 32) {
+        const auto bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+        const auto high = nibblesToHexAvx2(_mm256_and_si256(_mm256_srli_epi16(bytes, 4), lowMask));
+        const auto low = nibblesToHexAvx2(_mm256_and_si256(bytes, lowMask));
+        // unpack works within 128-bit lanes, so the lanes are put back in order
+        const auto first = _mm256_unpacklo_epi8(high, low);
+        const auto second = _mm256_unpackhi_epi8(high, low);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_permute2x128_si256(first, second, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 32), _mm256_permute2x128_si256(first, second, 0x31));
+        out += 64;
+    }
+    return encodeHexSse2(data + pos, size - pos, out);
+}
+
+// Base64 with AVX2 after W. Mula and D. Lemire, "Faster Base64 Encoding and Decoding
+// Using AVX2 Instructions". Each iteration reads 28 bytes and encodes 24 of them.
+FB_TARGET_AVX2 char* encodeBase64Avx2(const unsigned char* data, size_t size, char* out) noexcept
+{
+    // the bytes of each 3-byte group are spread over a 32-bit word as b1 b0 b2 b1
+    const auto spread = _mm256_setr_epi8(
+        1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+        1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+    // offsets from the 6-bit values to their characters, selected by value ranges
+    const auto offsets = _mm256_setr_epi8(
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0,
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+    size_t pos = 0;
+    for (; pos + 28 <= size; pos += 24) {
+        const auto low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+        const auto high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos + 12));
+        const auto bytes = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1), spread);
+
+        // move the four 6-bit values of each word into separate bytes
+        const auto first = _mm256_mulhi_epu16(_mm256_and_si256(bytes, _mm256_set1_epi32(0x0FC0FC00)),
+            _mm256_set1_epi32(0x04000040));
+        const auto second = _mm256_mullo_epi16(_mm256_and_si256(bytes, _mm256_set1_epi32(0x003F03F0)),
+            _mm256_set1_epi32(0x01000010));
+        const auto values = _mm256_or_si256(first, second);
+
+        // 0..25 -> 13, 26..51 -> 0, 52..63 -> 1..12
+        auto ranges = _mm256_subs_epu8(values, _mm256_set1_epi8(51));
+        ranges = _mm256_or_si256(ranges,
+            _mm256_and_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8(26), values), _mm256_set1_epi8(13)));
+        const auto chars = _mm256_add_epi8(values, _mm256_shuffle_epi8(offsets, ranges));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), chars);
+        out += 32;
+    }
+    return encodeBase64Scalar(data + pos, size - pos, out);
+}
+
+bool isAvx2Supported() noexcept
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    // OSXSAVE and AVX
+    if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0) {
+        return false;
+    }
+    // the OS saves the SSE and AVX registers
+    if ((_xgetbv(0) & 6) != 6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // FB_BINARY_ENCODING_X86
+
+SimdLevel detectSimdLevel() noexcept
+{
+#ifdef FB_BINARY_ENCODING_X86
+    // SSE2 is part of x86-64
+    return isAvx2Supported() ? SimdLevel::AVX2 : SimdLevel::SSE2;
+#else
+    return SimdLevel::SCALAR;
+#endif
+}
+
+} // namespace
+
+namespace FbUtils
+{
+
+    SimdLevel getSimdLevel() noexcept
+    {
+        static const SimdLevel level = detectSimdLevel();
+        return level;
+    }
+
+    const char* getSimdLevelName(SimdLevel level) noexcept
+    {
+        switch (level) {
+        case SimdLevel::SSE2:
+            return "sse2";
+        case SimdLevel::AVX2:
+            return "avx2";
+        default:
+            return "scalar";
+        }
+    }
+
+    char* encodeHex(const unsigned char* data, size_t size, char* out) noexcept
+    {
+        return encodeHex(data, size, out, getSimdLevel());
+    }
+
+    char* encodeHex(const unsigned char* data, size_t size, char* out, SimdLevel level) noexcept
+    {
+        if (level > getSimdLevel()) {
+            level = getSimdLevel();
+        }
+        switch (level) {
+#ifdef FB_BINARY_ENCODING_X86
+        case SimdLevel::AVX2:
+            return encodeHexAvx2(data, size, out);
+        case SimdLevel::SSE2:
+            return encodeHexSse2(data, size, out);
+#endif
+        default:
+            return encodeHexScalar(data, size, out);
+        }
+    }
+
+    char* encodeBase64(const unsigned char* data, size_t size, char* out) noexcept
+    {
+        return encodeBase64(data, size, out, getSimdLevel());
+    }
+
+    char* encodeBase64(const unsigned char* data, size_t size, char* out, SimdLevel level) noexcept
+    {
+#ifdef FB_BINARY_ENCODING_X86
+        if (level == SimdLevel::AVX2 && getSimdLevel() == SimdLevel::AVX2) {
+            return encodeBase64Avx2(data, size, out);
+        }
+#endif
+        return encodeBase64Scalar(data, size, out);
+    }
+
+    char* encode(const unsigned char* data, size_t size, char* out, BinaryEncoding encoding) noexcept
+    {
+        if (encoding == BinaryEncoding::BASE64) {
+            return encodeBase64(data, size, out);
+        }
+        return encodeHex(data, size, out);
+    }
+
+    std::string encode(const unsigned char* data, size_t size, BinaryEncoding encoding)
+    {
+        std::string output(encodedSize(size, encoding), '\0');
+        encode(data, size, output.data(), encoding);
+        return output;
+    }
+
+}
@@ -0,0 +1,64 @@
+#pragma once
+#ifndef FB_BINARY_ENCODING_H
+#define FB_BINARY_ENCODING_H
+
+#include <cstddef>
+#include <string>
+
+namespace FbUtils
+{
+
+    // Text representations of binary data.
+    enum class BinaryEncoding {
+        HEX,
+        BASE64
+    };
+
+    // Instruction sets used by the vectorized encoders.
+    enum class SimdLevel {
+        SCALAR,
+        SSE2,
+        AVX2
+    };
+
+    // The best level supported by the processor, detected once.
+    SimdLevel getSimdLevel() noexcept;
+    const char* getSimdLevelName(SimdLevel level) noexcept;
+
+    // Number of characters in the hex representation of size bytes.
+    constexpr size_t hexEncodedSize(size_t size) noexcept
+    {
+        return size * 2;
+    }
+
+    // Writes the upper case hex representation of size bytes to out, which must have room
+    // for hexEncodedSize(size) characters. Returns the end of the written text.
+    char* encodeHex(const unsigned char* data, size_t size, char* out) noexcept;
+    // The same with the given instruction set, for measurements. Levels the processor
+    // does not support fall back to the best supported one.
+    char* encodeHex(const unsigned char* data, size_t size, char* out, SimdLevel level) noexcept;
+
+    // Number of characters in the padded base64 representation of size bytes.
+    constexpr size_t base64EncodedSize(size_t size) noexcept
+    {
+        return (size + 2) / 3 * 4;
+    }
+
+    // Writes the standard padded base64 (RFC 4648) representation of size bytes to out, which must
+    // have room for base64EncodedSize(size) characters. Returns the end of the written text.
+    char* encodeBase64(const unsigned char* data, size_t size, char* out) noexcept;
+    // The same with the given instruction set, for measurements. There is no SSE2 version,
+    // it uses the scalar one.
+    char* encodeBase64(const unsigned char* data, size_t size, char* out, SimdLevel level) noexcept;
+
+    constexpr size_t encodedSize(size_t size, BinaryEncoding encoding) noexcept
+    {
+        return (encoding == BinaryEncoding::BASE64) ? base64EncodedSize(size) : hexEncodedSize(size);
+    }
+
+    char* encode(const unsigned char* data, size_t size, char* out, BinaryEncoding encoding) noexcept;
+    std::string encode(const unsigned char* data, size_t size, BinaryEncoding encoding);
+
+}
+
+#endif // FB_BINARY_ENCODING_H
@@ -0,0 +1,59 @@
+#include "BlobFileWriter.h"
+
+#include <algorithm>
+#include <climits>
+
+#include <zlib.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+uint32_t computeCrc32(const unsigned char* data, size_t size)
+{
+    uLong crc = crc32(0L, Z_NULL, 0);
+    while (size > 0) {
+        // zlib takes the length as uInt
+        const auto chunk = static_cast<uInt>(std::min<size_t>(size, UINT_MAX));
+        crc = crc32(crc, data, chunk);
+        data += chunk;
+        size -= chunk;
+    }
+    return static_cast<uint32_t>(crc);
+}
+
+} // namespace
+
+namespace FbUtils
+{
+
+    BlobFileWriter::BlobFileWriter(const fs::path& fileName)
+        : m_fileName(fileName)
+        , m_writer(nullptr)
+        , m_size(0)
+    {
+        fs::path tempFileName(m_fileName);
+        tempFileName += ".tmp";
+        m_writer = std::make_unique<BufferedFileWriter>(tempFileName);
+    }
+
+    BlobFileWriter::BlobLocation BlobFileWriter::append(const unsigned char* data, size_t size)
+    {
+        const BlobLocation location { m_size, size, computeCrc32(data, size) };
+        // large blobs bypass the buffer and go to the file in one write
+        m_writer->write(reinterpret_cast<const char*>(data), size);
+        m_size += size;
+        return location;
+    }
+
+    void BlobFileWriter::finish()
+    {
+        const auto tempFileName = m_writer->getFileName();
+        // the segment file refers to the blobs, they must be on disk before it appears
+        m_writer->sync();
+        m_writer->close();
+        m_writer = nullptr;
+        fs::rename(tempFileName, m_fileName);
+    }
+
+}
@@ -0,0 +1,47 @@
+#pragma once
+#ifndef FB_BLOB_FILE_WRITER_H
+#define FB_BLOB_FILE_WRITER_H
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+
+#include "BufferedFileWriter.h"
+
+namespace FbUtils
+{
+
+    // Writes blobs one after another into a sidecar file of a segment.
+    // The file is written under a temporary name and gets its own name in finish(),
+    // so a half-written file is never taken for a complete one.
+    class BlobFileWriter final
+    {
+    public:
+        // Location of a blob in the file.
+        struct BlobLocation {
+            uint64_t offset;
+            uint64_t length;
+            // CRC-32 of the blob data, as computed by zlib
+            uint32_t crc32;
+        };
+
+        explicit BlobFileWriter(const std::filesystem::path& fileName);
+
+        BlobFileWriter(const BlobFileWriter&) = delete;
+        BlobFileWriter& operator=(const BlobFileWriter&) = delete;
+
+        BlobLocation append(const unsigned char* data, size_t size);
+        // Syncs the file to disk, closes it and renames it to its own name.
+        void finish();
+
+        const std::filesystem::path& getFileName() const { return m_fileName; }
+
+    private:
+        std::filesystem::path m_fileName;
+        std::unique_ptr<BufferedFileWriter> m_writer;
+        uint64_t m_size = 0;
+    };
+
+}
+
+#endif // FB_BLOB_FILE_WRITER_H
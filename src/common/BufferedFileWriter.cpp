@@ -0,0 +1,110 @@
+#include "BufferedFileWriter.h"
+
+#include <cstring>
+
+#ifdef _WINDOWS
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "Utils.h"
+
+namespace fs = std::filesystem;
+
+namespace FbUtils
+{
+
+    BufferedFileWriter::BufferedFileWriter(const fs::path& fileName, size_t bufferSize)
+        : m_fileName(fileName)
+        , m_file(nullptr)
+        , m_buffer(bufferSize)
+        , m_used(0)
+    {
+#ifdef _WINDOWS
+        m_file = _wfopen(m_fileName.c_str(), L"wb");
+#else
+        m_file = std::fopen(m_fileName.c_str(), "wb");
+#endif
+        if (!m_file) {
+            raiseError(R"(Cannot open file "%s" for writing)", m_fileName.generic_string().c_str());
+        }
+        // all buffering is done by ourselves
+        std::setvbuf(m_file, nullptr, _IONBF, 0);
+    }
+
+    BufferedFileWriter::~BufferedFileWriter()
+    {
+        if (m_file) {
+            try {
+                flush();
+            } catch (...) {
+                // destructor must not throw
+            }
+            std::fclose(m_file);
+            m_file = nullptr;
+        }
+    }
+
+    void BufferedFileWriter::write(const char* data, size_t size)
+    {
+        if (size > m_buffer.size() - m_used) {
+            flush();
+            if (size >= m_buffer.size()) {
+                // the buffer would not help, write directly
+                writeFile(data, size);
+                return;
+            }
+        }
+        std::memcpy(m_buffer.data() + m_used, data, size);
+        m_used += size;
+    }
+
+    void BufferedFileWriter::flush()
+    {
+        if (m_used > 0) {
+            writeFile(m_buffer.data(), m_used);
+            m_used = 0;
+        }
+    }
+
+    void BufferedFileWriter::sync()
+    {
+        flush();
+        if (!m_file) {
+            return;
+        }
+#ifdef _WINDOWS
+        const auto rc = _commit(_fileno(m_file));
+#else
+        const auto rc = fsync(fileno(m_file));
+#endif
+        if (rc != 0) {
+            raiseError(R"(Error syncing file "%s")", m_fileName.generic_string().c_str());
+        }
+    }
+
+    void BufferedFileWriter::close()
+    {
+        if (!m_file) {
+            return;
+        }
+        flush();
+        const auto rc = std::fclose(m_file);
+        m_file = nullptr;
+        if (rc != 0) {
+            raiseError(R"(Error closing file "%s")", m_fileName.generic_string().c_str());
+        }
+    }
+
+    void BufferedFileWriter::writeFile(const char* data, size_t size)
+    {
+        if (!m_file) {
+            raiseError(R"(File "%s" is closed)", m_fileName.generic_string().c_str());
+        }
+        if (std::fwrite(data, 1, size, m_file) != size) {
+            raiseError(R"(Error writing to file "%s")", m_fileName.generic_string().c_str());
+        }
+    }
+
+}
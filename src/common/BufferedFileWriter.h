@@ -0,0 +1,64 @@
+#pragma once
+#ifndef FB_BUFFERED_FILE_WRITER_H
+#define FB_BUFFERED_FILE_WRITER_H
+
+#include <cstdio>
+#include <filesystem>
+#include <string_view>
+#include <vector>
+
+namespace FbUtils
+{
+
+    // Sequential byte sink. Implementations are not thread safe.
+    class OutputStream
+    {
+    public:
+        virtual ~OutputStream() = default;
+
+        virtual void write(const char* data, size_t size) = 0;
+        virtual void flush() = 0;
+        virtual void close() = 0;
+
+        void write(std::string_view s)
+        {
+            write(s.data(), s.size());
+        }
+    };
+
+    // Writes a file through its own buffer, so that many small writes
+    // turn into a few large sequential ones.
+    class BufferedFileWriter final : public OutputStream
+    {
+    public:
+        static constexpr size_t DEFAULT_BUFFER_SIZE = 1024 * 1024;
+
+        BufferedFileWriter() = delete;
+        explicit BufferedFileWriter(const std::filesystem::path& fileName, size_t bufferSize = DEFAULT_BUFFER_SIZE);
+        ~BufferedFileWriter() override;
+
+        BufferedFileWriter(const BufferedFileWriter&) = delete;
+        BufferedFileWriter& operator=(const BufferedFileWriter&) = delete;
+
+        void write(const char* data, size_t size) override;
+        void flush() override;
+        void close() override;
+        // Flushes the buffer and waits until the data reaches the disk.
+        void sync();
+
+        using OutputStream::write;
+
+        const std::filesystem::path& getFileName() const { return m_fileName; }
+
+    private:
+        void writeFile(const char* data, size_t size);
+
+        std::filesystem::path m_fileName;
+        std::FILE* m_file = nullptr;
+        std::vector<char> m_buffer;
+        size_t m_used = 0;
+    };
+
+}
+
+#endif // FB_BUFFERED_FILE_WRITER_H
@@ -0,0 +1,206 @@
+#include "CompressedStream.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include <zlib.h>
+#include <zstd.h>
+
+#include "Utils.h"
+
+namespace {
+
+using FbUtils::OutputStream;
+using FbUtils::raiseError;
+
+constexpr size_t GZIP_BUFFER_SIZE = 128 * 1024;
+
+struct ZstdContextDeleter
+{
+    void operator()(ZSTD_CCtx* context) const noexcept
+    {
+        ZSTD_freeCCtx(context);
+    }
+};
+
+// Writes the gzip format (RFC 1952) with zlib.
+class GzipOutputStream final : public OutputStream
+{
+public:
+    GzipOutputStream(OutputStream& sink, int level)
+        : m_sink(sink)
+        , m_stream()
+        , m_buffer(GZIP_BUFFER_SIZE)
+        , m_finished(false)
+    {
+        // 15 window bits + 16 selects the gzip header instead of the zlib one
+        const auto rc = deflateInit2(&m_stream, (level == 0) ? Z_DEFAULT_COMPRESSION : level,
+            Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY);
+        if (rc != Z_OK) {
+            raiseError("Cannot initialize gzip compression, error %d", rc);
+        }
+    }
+
+    ~GzipOutputStream() override
+    {
+        deflateEnd(&m_stream);
+    }
+
+    void write(const char* data, size_t size) override
+    {
+        m_stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+        while (size > 0) {
+            // avail_in is 32-bit
+            const auto portion = static_cast<uInt>(std::min<size_t>(size, 0x40000000));
+            m_stream.avail_in = portion;
+            do {
+                deflateStep(Z_NO_FLUSH);
+            } while (m_stream.avail_in > 0);
+            size -= portion;
+        }
+    }
+
+    void flush() override
+    {
+        // a forced flush would worsen the compression ratio
+        m_sink.flush();
+    }
+
+    void close() override
+    {
+        if (m_finished) {
+            return;
+        }
+        m_stream.next_in = nullptr;
+        m_stream.avail_in = 0;
+        while (deflateStep(Z_FINISH) != Z_STREAM_END) {
+        }
+        m_finished = true;
+        m_sink.flush();
+    }
+
+    using OutputStream::write;
+
+private:
+    int deflateStep(int flush)
+    {
+        m_stream.next_out = reinterpret_cast<Bytef*>(m_buffer.data());
+        m_stream.avail_out = static_cast<uInt>(m_buffer.size());
+        const auto rc = deflate(&m_stream, flush);
+        if (rc == Z_STREAM_ERROR) {
+            raiseError("gzip compression error");
+        }
+        const auto produced = m_buffer.size() - m_stream.avail_out;
+        if (produced > 0) {
+            m_sink.write(m_buffer.data(), produced);
+        }
+        return rc;
+    }
+
+    OutputStream& m_sink;
+    z_stream m_stream;
+    std::vector<char> m_buffer;
+    bool m_finished = false;
+};
+
+// Writes a zstd frame with a content checksum.
+class ZstdOutputStream final : public OutputStream
+{
+public:
+    ZstdOutputStream(OutputStream& sink, int level)
+        : m_sink(sink)
+        , m_context(ZSTD_createCCtx())
+        , m_buffer(ZSTD_CStreamOutSize())
+        , m_finished(false)
+    {
+        if (!m_context) {
+            raiseError("Cannot create zstd compression context");
+        }
+        checkResult(ZSTD_CCtx_setParameter(m_context.get(), ZSTD_c_compressionLevel, level));
+        checkResult(ZSTD_CCtx_setParameter(m_context.get(), ZSTD_c_checksumFlag, 1));
+    }
+
+    void write(const char* data, size_t size) override
+    {
+        ZSTD_inBuffer input { data, size, 0 };
+        while (input.pos < input.size) {
+            compressStep(input, ZSTD_e_continue);
+        }
+    }
+
+    void flush() override
+    {
+        // a forced flush would worsen the compression ratio
+        m_sink.flush();
+    }
+
+    void close() override
+    {
+        if (m_finished) {
+            return;
+        }
+        ZSTD_inBuffer input { nullptr, 0, 0 };
+        while (compressStep(input, ZSTD_e_end) != 0) {
+        }
+        m_finished = true;
+        m_sink.flush();
+    }
+
+    using OutputStream::write;
+
+private:
+    size_t compressStep(ZSTD_inBuffer& input, ZSTD_EndDirective mode)
+    {
+        ZSTD_outBuffer output { m_buffer.data(), m_buffer.size(), 0 };
+        const auto remaining = checkResult(ZSTD_compressStream2(m_context.get(), &output, &input, mode));
+        if (output.pos > 0) {
+            m_sink.write(m_buffer.data(), output.pos);
+        }
+        return remaining;
+    }
+
+    static size_t checkResult(size_t code)
+    {
+        if (ZSTD_isError(code)) {
+            raiseError("zstd compression error: %s", ZSTD_getErrorName(code));
+        }
+        return code;
+    }
+
+    OutputStream& m_sink;
+    std::unique_ptr<ZSTD_CCtx, ZstdContextDeleter> m_context;
+    std::vector<char> m_buffer;
+    bool m_finished = false;
+};
+
+} // namespace
+
+namespace FbUtils
+{
+
+    const char* getCompressionExtension(Compression compression)
+    {
+        switch (compression) {
+        case Compression::GZIP:
+            return ".gz";
+        case Compression::ZSTD:
+            return ".zst";
+        default:
+            return "";
+        }
+    }
+
+    std::unique_ptr<OutputStream> createCompressedStream(Compression compression, int level, OutputStream& sink)
+    {
+        switch (compression) {
+        case Compression::GZIP:
+            return std::make_unique<GzipOutputStream>(sink, level);
+        case Compression::ZSTD:
+            return std::make_unique<ZstdOutputStream>(sink, level);
+        default:
+            return nullptr;
+        }
+    }
+
+}
@@ -0,0 +1,29 @@
+#pragma once
+#ifndef FB_COMPRESSED_STREAM_H
+#define FB_COMPRESSED_STREAM_H
+
+#include <memory>
+
+#include "BufferedFileWriter.h"
+
+namespace FbUtils
+{
+
+    enum class Compression {
+        NONE,
+        GZIP,
+        ZSTD
+    };
+
+    // File name suffix for the compressed output, e.g. ".gz"
+    const char* getCompressionExtension(Compression compression);
+
+    // Creates a stream that compresses the written data into sink.
+    // Level 0 means the default level of the compression library.
+    // close() writes the end of the compressed stream and flushes sink, but does not close it.
+    // For Compression::NONE nullptr is returned.
+    std::unique_ptr<OutputStream> createCompressedStream(Compression compression, int level, OutputStream& sink);
+
+}
+
+#endif // FB_COMPRESSED_STREAM_H
@@ -0,0 +1,208 @@
+#include "DateTimeFormatter.h"
+
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+using namespace Firebird;
+
+namespace {
+
+constexpr ISC_TIME TIME_UNITS_PER_SECOND = 10000;
+constexpr int64_t TIME_UNITS_PER_MINUTE = 60 * TIME_UNITS_PER_SECOND;
+constexpr int64_t TIME_UNITS_PER_DAY = 24 * 60 * TIME_UNITS_PER_MINUTE;
+// Firebird encodes a fixed offset of N minutes as the zone id N + ONE_DAY,
+// the ids of named zones go down from 65535
+constexpr int ONE_DAY = 24 * 60 - 1;
+
+// Writes the value as exactly N decimal digits.
+template <unsigned N>
+inline char* writeDigits(unsigned value, char* out) noexcept
+{
+    for (unsigned i = N; i > 0; i--) {
+        out[i - 1] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+    return out + N;
+}
+
+char* writeDate(unsigned year, unsigned month, unsigned day, char* out) noexcept
+{
+    out = writeDigits<4>(year, out);
+    *out++ = '-';
+    out = writeDigits<2>(month, out);
+    *out++ = '-';
+    return writeDigits<2>(day, out);
+}
+
+char* writeTime(unsigned hours, unsigned minutes, unsigned seconds, unsigned fractions, char* out) noexcept
+{
+    out = writeDigits<2>(hours, out);
+    *out++ = ':';
+    out = writeDigits<2>(minutes, out);
+    *out++ = ':';
+    out = writeDigits<2>(seconds, out);
+    *out++ = '.';
+    return writeDigits<4>(fractions, out);
+}
+
+char* writeTimeZone(std::string_view name, char* out) noexcept
+{
+    *out++ = ' ';
+    memcpy(out, name.data(), name.size());
+    return out + name.size();
+}
+
+} // namespace
+
+namespace FbUtils
+{
+
+    DateTimeFormatter::DateTimeFormatter() noexcept
+        : m_cache()
+        , m_util(nullptr)
+        , m_timeZones()
+    {
+        resetCache();
+    }
+
+    void DateTimeFormatter::init(IUtil* util) noexcept
+    {
+        m_util = util;
+    }
+
+    void DateTimeFormatter::decodeDate(ISC_DATE date, unsigned& year, unsigned& month, unsigned& day) noexcept
+    {
+        // days from 0000-03-01 of the proleptic Gregorian calendar
+        int64_t days = static_cast<int64_t>(date) + 2400001 - 1721119;
+        const int64_t century = (4 * days - 1) / 146097;
+        days = 4 * days - 1 - 146097 * century;
+        days = days / 4;
+        const int64_t centuryYear = (4 * days + 3) / 1461;
+        days = 4 * days + 3 - 1461 * centuryYear;
+        days = (days + 4) / 4;
+        int64_t m = (5 * days - 3) / 153;
+        days = 5 * days - 3 - 153 * m;
+        days = (days + 5) / 5;
+        int64_t y = 100 * century + centuryYear;
+        // the year starts in March
+        if (m < 10) {
+            m += 3;
+        } else {
+            m -= 9;
+            y += 1;
+        }
+        year = static_cast<unsigned>(y);
+        month = static_cast<unsigned>(m);
+        day = static_cast<unsigned>(days);
+    }
+
+    void DateTimeFormatter::decodeTime(ISC_TIME time, unsigned& hours, unsigned& minutes, unsigned& seconds, unsigned& fractions) noexcept
+    {
+        const auto totalSeconds = time / TIME_UNITS_PER_SECOND;
+        hours = totalSeconds / 3600;
+        minutes = totalSeconds / 60 % 60;
+        seconds = totalSeconds % 60;
+        fractions = time % TIME_UNITS_PER_SECOND;
+    }
+
+    char* DateTimeFormatter::formatDate(ISC_DATE date, char* out) noexcept
+    {
+        auto& cached = m_cache[static_cast<unsigned>(date) % CACHE_SIZE];
+        if (!cached.valid || cached.date != date) {
+            unsigned year = 0, month = 0, day = 0;
+            decodeDate(date, year, month, day);
+            writeDate(year, month, day, cached.text);
+            cached.date = date;
+            cached.valid = true;
+        }
+        memcpy(out, cached.text, DATE_SIZE);
+        return out + DATE_SIZE;
+    }
+
+    char* DateTimeFormatter::formatTime(ISC_TIME time, char* out) noexcept
+    {
+        unsigned hours = 0, minutes = 0, seconds = 0, fractions = 0;
+        decodeTime(time, hours, minutes, seconds, fractions);
+        return writeTime(hours, minutes, seconds, fractions, out);
+    }
+
+    char* DateTimeFormatter::formatTimestamp(const ISC_TIMESTAMP& timestamp, char* out) noexcept
+    {
+        out = formatDate(timestamp.timestamp_date, out);
+        *out++ = ' ';
+        return formatTime(timestamp.timestamp_time, out);
+    }
+
+    char* DateTimeFormatter::formatTimeTz(ThrowStatusWrapper* status, const ISC_TIME_TZ& time, char* out)
+    {
+        const auto& timeZone = getTimeZone(status, time.time_zone);
+        if (timeZone.fixedOffset) {
+            auto local = (static_cast<int64_t>(time.utc_time) + timeZone.displacement * TIME_UNITS_PER_MINUTE) % TIME_UNITS_PER_DAY;
+            if (local < 0) {
+                local += TIME_UNITS_PER_DAY;
+            }
+            out = formatTime(static_cast<ISC_TIME>(local), out);
+        } else {
+            // the offset of a named zone depends on the date, so it is left to ICU
+            unsigned hours = 0, minutes = 0, seconds = 0, fractions = 0;
+            m_util->decodeTimeTz(status, &time, &hours, &minutes, &seconds, &fractions, 0, nullptr);
+            out = writeTime(hours, minutes, seconds, fractions, out);
+        }
+        return writeTimeZone(timeZone.name, out);
+    }
+
+    char* DateTimeFormatter::formatTimestampTz(ThrowStatusWrapper* status, const ISC_TIMESTAMP_TZ& timestamp, char* out)
+    {
+        const auto& timeZone = getTimeZone(status, timestamp.time_zone);
+        if (timeZone.fixedOffset) {
+            const auto& utc = timestamp.utc_timestamp;
+            const int64_t ticks = static_cast<int64_t>(utc.timestamp_date) * TIME_UNITS_PER_DAY + utc.timestamp_time
+                + timeZone.displacement * TIME_UNITS_PER_MINUTE;
+            // floor division, dates before 1858-11-17 are negative
+            auto days = ticks / TIME_UNITS_PER_DAY;
+            auto time = ticks % TIME_UNITS_PER_DAY;
+            if (time < 0) {
+                time += TIME_UNITS_PER_DAY;
+                --days;
+            }
+            const ISC_TIMESTAMP local { static_cast<ISC_DATE>(days), static_cast<ISC_TIME>(time) };
+            out = formatTimestamp(local, out);
+        } else {
+            unsigned year = 0, month = 0, day = 0;
+            unsigned hours = 0, minutes = 0, seconds = 0, fractions = 0;
+            m_util->decodeTimeStampTz(status, &timestamp, &year, &month, &day, &hours, &minutes, &seconds, &fractions, 0, nullptr);
+            out = writeDate(year, month, day, out);
+            *out++ = ' ';
+            out = writeTime(hours, minutes, seconds, fractions, out);
+        }
+        return writeTimeZone(timeZone.name, out);
+    }
+
+    const DateTimeFormatter::TimeZone& DateTimeFormatter::getTimeZone(ThrowStatusWrapper* status, ISC_USHORT timeZoneId)
+    {
+        const auto it = m_timeZones.find(timeZoneId);
+        if (it != m_timeZones.end()) {
+            return it->second;
+        }
+        // the name does not depend on the value, any time gives it
+        const ISC_TIME_TZ probe { 0, timeZoneId };
+        unsigned hours = 0, minutes = 0, seconds = 0, fractions = 0;
+        char name[TIME_ZONE_NAME_SIZE] = { '\0' };
+        m_util->decodeTimeTz(status, &probe, &hours, &minutes, &seconds, &fractions, TIME_ZONE_NAME_SIZE, name);
+
+        TimeZone timeZone;
+        timeZone.name.assign(name, strnlen(name, TIME_ZONE_NAME_SIZE));
+        timeZone.fixedOffset = timeZoneId <= 2 * ONE_DAY;
+        timeZone.displacement = timeZone.fixedOffset ? static_cast<int>(timeZoneId) - ONE_DAY : 0;
+        return m_timeZones.emplace(timeZoneId, std::move(timeZone)).first->second;
+    }
+
+    void DateTimeFormatter::resetCache() noexcept
+    {
+        for (auto& cached : m_cache) {
+            cached.valid = false;
+        }
+    }
+
+}
@@ -0,0 +1,77 @@
+#pragma once
+#ifndef FB_DATE_TIME_FORMATTER_H
+#define FB_DATE_TIME_FORMATTER_H
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "firebird/Interface.h"
+
+namespace FbUtils
+{
+
+    // Formats DATE, TIME and TIMESTAMP values without IUtil: YYYY-MM-DD, HH:MM:SS.ffff and both
+    // separated by a space. The fraction is always four digits, 0.0005 s is written as .0005.
+    // Recently formatted dates are cached, since the rows of a segment mostly share a few days.
+    // Values with time zone are followed by the zone name. The names are looked up once per zone,
+    // values in fixed offset zones are converted from UTC without IUtil.
+    class DateTimeFormatter final
+    {
+    public:
+        static constexpr unsigned DATE_SIZE = 10;
+        static constexpr unsigned TIME_SIZE = 13;
+        static constexpr unsigned TIMESTAMP_SIZE = DATE_SIZE + 1 + TIME_SIZE;
+        // the longest zone name IUtil may return, with the terminating zero
+        static constexpr unsigned TIME_ZONE_NAME_SIZE = 252;
+        static constexpr unsigned TIME_TZ_SIZE = TIME_SIZE + 1 + TIME_ZONE_NAME_SIZE;
+        static constexpr unsigned TIMESTAMP_TZ_SIZE = TIMESTAMP_SIZE + 1 + TIME_ZONE_NAME_SIZE;
+
+        DateTimeFormatter() noexcept;
+
+        // IUtil is needed for the values with time zone only.
+        void init(Firebird::IUtil* util) noexcept;
+
+        // The algorithm of Firebird's NoThrowTimeStamp::decode_date: days since 1858-11-17
+        // to the proleptic Gregorian calendar.
+        static void decodeDate(ISC_DATE date, unsigned& year, unsigned& month, unsigned& day) noexcept;
+        static void decodeTime(ISC_TIME time, unsigned& hours, unsigned& minutes, unsigned& seconds, unsigned& fractions) noexcept;
+
+        // The functions write exactly *_SIZE characters and return their end.
+        char* formatDate(ISC_DATE date, char* out) noexcept;
+        static char* formatTime(ISC_TIME time, char* out) noexcept;
+        char* formatTimestamp(const ISC_TIMESTAMP& timestamp, char* out) noexcept;
+
+        // The functions write at most *_TZ_SIZE characters and return their end.
+        char* formatTimeTz(Firebird::ThrowStatusWrapper* status, const ISC_TIME_TZ& time, char* out);
+        char* formatTimestampTz(Firebird::ThrowStatusWrapper* status, const ISC_TIMESTAMP_TZ& timestamp, char* out);
+
+        // Forgets the cached dates.
+        void resetCache() noexcept;
+
+    private:
+        static constexpr unsigned CACHE_SIZE = 8;
+
+        struct CachedDate {
+            ISC_DATE date;
+            bool valid;
+            char text[DATE_SIZE];
+        };
+
+        struct TimeZone {
+            std::string name;
+            bool fixedOffset;
+            // minutes east of UTC for fixed offset zones
+            int displacement;
+        };
+
+        const TimeZone& getTimeZone(Firebird::ThrowStatusWrapper* status, ISC_USHORT timeZoneId);
+
+        CachedDate m_cache[CACHE_SIZE];
+        Firebird::IUtil* m_util;
+        std::unordered_map<ISC_USHORT, TimeZone> m_timeZones;
+    };
+
+}
+
+#endif // FB_DATE_TIME_FORMATTER_H
@@ -0,0 +1,61 @@
+#include "EventBuffer.h"
+
+namespace FbUtils
+{
+
+    void EventBuffer::append(std::string_view event, unsigned kind)
+    {
+        append({ event }, kind);
+    }
+
+    void EventBuffer::append(std::initializer_list<std::string_view> parts, unsigned kind)
+    {
+        const auto dataSize = m_data.size();
+        try {
+            for (const auto part : parts) {
+                m_data.append(part);
+            }
+            m_events.push_back({ m_data.size(), kind });
+        } catch (...) {
+            m_data.resize(dataSize);
+            throw;
+        }
+    }
+
+    void EventBuffer::startSavepoint()
+    {
+        m_savepoints.push_back({ m_data.size(), m_events.size() });
+    }
+
+    void EventBuffer::releaseSavepoint() noexcept
+    {
+        if (!m_savepoints.empty()) {
+            m_savepoints.pop_back();
+        }
+    }
+
+    void EventBuffer::rollbackSavepoint() noexcept
+    {
+        if (m_savepoints.empty()) {
+            return;
+        }
+        const auto savepoint = m_savepoints.back();
+        m_savepoints.pop_back();
+        m_data.resize(savepoint.dataSize);
+        m_events.resize(savepoint.eventCount);
+    }
+
+    void EventBuffer::clear() noexcept
+    {
+        if (m_data.capacity() > MAX_RETAINED_SIZE) {
+            // a huge transaction should not pin its memory in a reused buffer
+            std::string().swap(m_data);
+            std::vector<Event>().swap(m_events);
+        } else {
+            m_data.clear();
+            m_events.clear();
+        }
+        m_savepoints.clear();
+    }
+
+}
@@ -0,0 +1,75 @@
+#pragma once
+#ifndef FB_EVENT_BUFFER_H
+#define FB_EVENT_BUFFER_H
+
+#include <cstddef>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace FbUtils
+{
+
+    // Serialized events of one transaction, kept until it ends. The events are stored back to back
+    // in one string. A savepoint remembers the current end, so rolling it back only truncates.
+    // Each event has a kind, a number the buffer keeps for the caller without interpreting it.
+    class EventBuffer final
+    {
+    public:
+        // memory kept for reuse after clear(), a larger buffer is freed
+        static constexpr size_t MAX_RETAINED_SIZE = 1024 * 1024;
+
+        EventBuffer() = default;
+
+        EventBuffer(const EventBuffer&) = delete;
+        EventBuffer& operator=(const EventBuffer&) = delete;
+
+        void append(std::string_view event, unsigned kind = 0);
+        // Appends one event made of the parts, without joining them first.
+        void append(std::initializer_list<std::string_view> parts, unsigned kind);
+
+        void startSavepoint();
+        // Keeps the events of the innermost savepoint.
+        void releaseSavepoint() noexcept;
+        // Discards the events of the innermost savepoint.
+        void rollbackSavepoint() noexcept;
+
+        // Discards all events and savepoints.
+        void clear() noexcept;
+
+        // Number of events.
+        size_t size() const noexcept { return m_events.size(); }
+        bool empty() const noexcept { return m_events.empty(); }
+
+        // Calls f(std::string_view event, unsigned kind) for each event in the order they were appended.
+        template <typename F>
+        void forEach(F&& f) const
+        {
+            const std::string_view data(m_data);
+            size_t start = 0;
+            for (const auto& event : m_events) {
+                f(data.substr(start, event.end - start), event.kind);
+                start = event.end;
+            }
+        }
+
+    private:
+        struct Event {
+            size_t end;
+            unsigned kind;
+        };
+
+        struct Savepoint {
+            size_t dataSize;
+            size_t eventCount;
+        };
+
+        std::string m_data;
+        std::vector<Event> m_events;
+        std::vector<Savepoint> m_savepoints;
+    };
+
+}
+
+#endif // FB_EVENT_BUFFER_H
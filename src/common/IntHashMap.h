@@ -0,0 +1,159 @@
+#pragma once
+#ifndef FB_INT_HASH_MAP_H
+#define FB_INT_HASH_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace FbUtils
+{
+
+    // Hash map with integer keys and open addressing: the entries are kept in one array
+    // and collisions go to the next free slot (linear probing). Erasing shifts the following
+    // entries back, so there are no tombstones and lookups stay short after many erases.
+    // The table is at most half full, its size is a power of two.
+    template <typename Key, typename Value>
+    class IntHashMap final
+    {
+        static_assert(std::is_integral_v<Key>, "IntHashMap keys must be integers");
+
+    public:
+        IntHashMap()
+            : m_slots(MIN_CAPACITY)
+            , m_mask(MIN_CAPACITY - 1)
+            , m_size(0)
+        {
+        }
+
+        size_t size() const noexcept { return m_size; }
+        bool empty() const noexcept { return m_size == 0; }
+
+        // Returns nullptr if there is no such key.
+        Value* find(Key key) noexcept
+        {
+            for (size_t i = indexOf(key);; i = (i + 1) & m_mask) {
+                auto& slot = m_slots[i];
+                if (!slot.used) {
+                    return nullptr;
+                }
+                if (slot.key == key) {
+                    return &slot.value;
+                }
+            }
+        }
+
+        void insertOrAssign(Key key, Value value)
+        {
+            if ((m_size + 1) * 2 > m_slots.size()) {
+                rehash(m_slots.size() * 2);
+            }
+            size_t i = indexOf(key);
+            for (; m_slots[i].used; i = (i + 1) & m_mask) {
+                if (m_slots[i].key == key) {
+                    m_slots[i].value = std::move(value);
+                    return;
+                }
+            }
+            m_slots[i] = { key, std::move(value), true };
+            ++m_size;
+        }
+
+        // Returns false if there is no such key.
+        bool erase(Key key) noexcept
+        {
+            for (size_t i = indexOf(key);; i = (i + 1) & m_mask) {
+                const auto& slot = m_slots[i];
+                if (!slot.used) {
+                    return false;
+                }
+                if (slot.key == key) {
+                    eraseAt(i);
+                    return true;
+                }
+            }
+        }
+
+        // Calls f(key, value) for each entry and removes the entry after the call.
+        // If f throws, the entry and the ones not visited yet stay in the map.
+        template <typename F>
+        void drain(F&& f)
+        {
+            for (size_t i = 0; i < m_slots.size() && m_size > 0;) {
+                auto& slot = m_slots[i];
+                if (!slot.used) {
+                    ++i;
+                    continue;
+                }
+                f(slot.key, slot.value);
+                // an entry from further on may be shifted into this slot, so it is checked again
+                eraseAt(i);
+            }
+        }
+
+        void clear() noexcept
+        {
+            for (auto& slot : m_slots) {
+                slot = Slot();
+            }
+            m_size = 0;
+        }
+
+    private:
+        static constexpr size_t MIN_CAPACITY = 16;
+
+        struct Slot {
+            Key key {};
+            Value value {};
+            bool used = false;
+        };
+
+        size_t indexOf(Key key) const noexcept
+        {
+            // Fibonacci hashing spreads consecutive numbers, such as transaction numbers, over the table
+            const auto hash = static_cast<uint64_t>(key) * 0x9E3779B97F4A7C15ULL;
+            return static_cast<size_t>(hash >> 32) & m_mask;
+        }
+
+        void eraseAt(size_t hole) noexcept
+        {
+            // move back the entries whose probe sequence passes the hole
+            for (size_t i = (hole + 1) & m_mask; m_slots[i].used; i = (i + 1) & m_mask) {
+                const auto home = indexOf(m_slots[i].key);
+                // the entry stays if its home slot lies cyclically in (hole, i]
+                const bool stays = (hole <= i) ? (hole < home && home <= i) : (hole < home || home <= i);
+                if (!stays) {
+                    m_slots[hole] = std::move(m_slots[i]);
+                    hole = i;
+                }
+            }
+            m_slots[hole] = Slot();
+            --m_size;
+        }
+
+        void rehash(size_t capacity)
+        {
+            std::vector<Slot> slots(capacity);
+            std::swap(m_slots, slots);
+            m_mask = capacity - 1;
+            for (auto& slot : slots) {
+                if (slot.used) {
+                    size_t i = indexOf(slot.key);
+                    while (m_slots[i].used) {
+                        i = (i + 1) & m_mask;
+                    }
+                    m_slots[i] = std::move(slot);
+                }
+            }
+        }
+
+        std::vector<Slot> m_slots;
+        size_t m_mask;
+        size_t m_size;
+    };
+
+}
+
+#endif // FB_INT_HASH_MAP_H
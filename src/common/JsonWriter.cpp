@@ -0,0 +1,299 @@
+#include "JsonWriter.h"
+
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FB_JSON_WRITER_SSE2
+#endif
+
+#include <nlohmann/json.hpp>
+
+#include "Utils.h"
+
+namespace {
+
+constexpr const char hex_digits_lower[] = "0123456789abcdef";
+
+// Returns the number of leading bytes of data that are printable ASCII characters
+// other than '"' and '\\', i.e. can be copied to the output as is.
+size_t plainAsciiLength(const char* data, size_t size) noexcept
+{
+    size_t pos = 0;
+#if defined(__AVX2__)
+    // bytes below 0x20 and from 0x80 are both less than 0x20 as signed chars
+    const auto control = _mm256_set1_epi8(0x20);
+    const auto quote = _mm256_set1_epi8('"');
+    const auto backslash = _mm256_set1_epi8('\\');
+    for (; pos + 32 <= size; pos += 32) {
+        const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+        const auto special = _mm256_or_si256(_mm256_cmpgt_epi8(control, chunk),
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote), _mm256_cmpeq_epi8(chunk, backslash)));
+        const auto mask = static_cast<unsigned>(_mm256_movemask_epi8(special));
+        if (mask != 0) {
+            return pos + std::countr_zero(mask);
+        }
+    }
+#elif defined(FB_JSON_WRITER_SSE2)
+    // bytes below 0x20 and from 0x80 are both less than 0x20 as signed chars
+    const auto control = _mm_set1_epi8(0x20);
+    const auto quote = _mm_set1_epi8('"');
+    const auto backslash = _mm_set1_epi8('\\');
+    for (; pos + 16 <= size; pos += 16) {
+        const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+        const auto special = _mm_or_si128(_mm_cmplt_epi8(chunk, control),
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)));
+        const auto mask = static_cast<unsigned>(_mm_movemask_epi8(special));
+        if (mask != 0) {
+            return pos + std::countr_zero(mask);
+        }
+    }
+#else
+    // eight bytes at a time: a byte is special if it is below 0x20, from 0x80, '"' or '\\'
+    constexpr uint64_t ones = 0x0101010101010101ULL;
+    constexpr uint64_t highBits = 0x8080808080808080ULL;
+    for (; pos + 8 <= size; pos += 8) {
+        uint64_t word;
+        memcpy(&word, data + pos, sizeof(word));
+        const auto quotes = word ^ (ones * '"');
+        const auto backslashes = word ^ (ones * '\\');
+        const auto special = ((word - ones * 0x20) | (quotes - ones) | (backslashes - ones) | word) & highBits;
+        if (special != 0) {
+            break;
+        }
+    }
+#endif
+    while (pos < size) {
+        const auto c = static_cast<unsigned char>(data[pos]);
+        if (c < 0x20 || c >= 0x80 || c == '"' || c == '\\') {
+            break;
+        }
+        ++pos;
+    }
+    return pos;
+}
+
+// Returns the length of the valid UTF-8 sequence starting at s[pos], or 0 if it is invalid.
+size_t utf8SequenceLength(std::string_view s, size_t pos) noexcept
+{
+    const auto c = static_cast<unsigned char>(s[pos]);
+    unsigned char lo = 0x80, hi = 0xBF;
+    size_t length = 0;
+    if (c >= 0xC2 && c <= 0xDF) {
+        length = 2;
+    } else if (c >= 0xE0 && c <= 0xEF) {
+        length = 3;
+        if (c == 0xE0)
+            lo = 0xA0;
+        else if (c == 0xED)
+            hi = 0x9F;
+    } else if (c >= 0xF0 && c <= 0xF4) {
+        length = 4;
+        if (c == 0xF0)
+            lo = 0x90;
+        else if (c == 0xF4)
+            hi = 0x8F;
+    } else {
+        return 0;
+    }
+    if (pos + length > s.size()) {
+        return 0;
+    }
+    const auto c1 = static_cast<unsigned char>(s[pos + 1]);
+    if (c1 < lo || c1 > hi) {
+        return 0;
+    }
+    for (size_t i = 2; i < length; ++i) {
+        const auto cn = static_cast<unsigned char>(s[pos + i]);
+        if (cn < 0x80 || cn > 0xBF) {
+            return 0;
+        }
+    }
+    return length;
+}
+
+} // namespace
+
+namespace FbUtils
+{
+
+    void JsonWriter::startObject()
+    {
+        separator();
+        m_buffer.push_back('{');
+        m_needComma = false;
+    }
+
+    void JsonWriter::endObject()
+    {
+        m_buffer.push_back('}');
+        m_needComma = true;
+    }
+
+    void JsonWriter::startArray()
+    {
+        separator();
+        m_buffer.push_back('[');
+        m_needComma = false;
+    }
+
+    void JsonWriter::endArray()
+    {
+        m_buffer.push_back(']');
+        m_needComma = true;
+    }
+
+    void JsonWriter::key(std::string_view name)
+    {
+        separator();
+        m_buffer.push_back('"');
+        escape(m_buffer, name);
+        m_buffer.append("\":", 2);
+        m_needComma = false;
+    }
+
+    void JsonWriter::rawKey(std::string_view fragment)
+    {
+        separator();
+        m_buffer.append(fragment);
+        m_needComma = false;
+    }
+
+    void JsonWriter::nullValue()
+    {
+        separator();
+        m_buffer.append("null", 4);
+        m_needComma = true;
+    }
+
+    void JsonWriter::boolValue(bool value)
+    {
+        separator();
+        if (value)
+            m_buffer.append("true", 4);
+        else
+            m_buffer.append("false", 5);
+        m_needComma = true;
+    }
+
+    void JsonWriter::intValue(int64_t value)
+    {
+        separator();
+        char buffer[24];
+        const auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        m_buffer.append(buffer, end);
+        m_needComma = true;
+    }
+
+    void JsonWriter::uintValue(uint64_t value)
+    {
+        separator();
+        char buffer[24];
+        const auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        m_buffer.append(buffer, end);
+        m_needComma = true;
+    }
+
+    void JsonWriter::doubleValue(double value)
+    {
+        separator();
+        if (!std::isfinite(value)) {
+            // nlohmann::json writes NaN and infinity as null
+            m_buffer.append("null", 4);
+        } else {
+            // the same shortest round-trip algorithm nlohmann::json uses; detail is not a public API,
+            // the json-writer test group notices if a new version of the library writes otherwise
+            char buffer[64];
+            const auto end = nlohmann::detail::to_chars(buffer, buffer + sizeof(buffer), value);
+            m_buffer.append(buffer, end);
+        }
+        m_needComma = true;
+    }
+
+    void JsonWriter::stringValue(std::string_view value)
+    {
+        separator();
+        m_buffer.push_back('"');
+        escape(m_buffer, value);
+        m_buffer.push_back('"');
+        m_needComma = true;
+    }
+
+    void JsonWriter::binaryValue(const unsigned char* data, size_t size, BinaryEncoding encoding)
+    {
+        separator();
+        m_buffer.push_back('"');
+        const auto offset = m_buffer.size();
+        m_buffer.resize(offset + encodedSize(size, encoding));
+        encode(data, size, m_buffer.data() + offset, encoding);
+        m_buffer.push_back('"');
+        m_needComma = true;
+    }
+
+    void JsonWriter::rawValue(std::string_view json)
+    {
+        separator();
+        m_buffer.append(json);
+        m_needComma = true;
+    }
+
+    void JsonWriter::escape(std::string& out, std::string_view s)
+    {
+        size_t runStart = 0;
+        size_t pos = 0;
+        const size_t size = s.size();
+        while (pos < size) {
+            // runs that need no escaping are copied at once
+            pos += plainAsciiLength(s.data() + pos, size - pos);
+            if (pos == size) {
+                break;
+            }
+            const auto c = static_cast<unsigned char>(s[pos]);
+            if (c >= 0x80) {
+                const auto length = utf8SequenceLength(s, pos);
+                if (length == 0) {
+                    raiseError("invalid UTF-8 byte at index %u: 0x%02X", static_cast<unsigned>(pos), c);
+                }
+                pos += length;
+                continue;
+            }
+            out.append(s.data() + runStart, pos - runStart);
+            switch (c) {
+            case '"':
+                out.append("\\\"", 2);
+                break;
+            case '\\':
+                out.append("\\\\", 2);
+                break;
+            case '\b':
+                out.append("\\b", 2);
+                break;
+            case '\f':
+                out.append("\\f", 2);
+                break;
+            case '\n':
+                out.append("\\n", 2);
+                break;
+            case '\r':
+                out.append("\\r", 2);
+                break;
+            case '\t':
+                out.append("\\t", 2);
+                break;
+            default: {
+                const char u[6] = { '\\', 'u', '0', '0', hex_digits_lower[c >> 4], hex_digits_lower[c & 15] };
+                out.append(u, sizeof(u));
+            }
+            }
+            ++pos;
+            runStart = pos;
+        }
+        out.append(s.data() + runStart, size - runStart);
+    }
+
+}
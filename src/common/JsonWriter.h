@@ -0,0 +1,69 @@
+#pragma once
+#ifndef FB_JSON_WRITER_H
+#define FB_JSON_WRITER_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "BinaryEncoding.h"
+
+namespace FbUtils
+{
+
+    // Writes compact JSON text straight into a reusable buffer.
+    // The output is byte-identical to nlohmann::json::dump() without indentation.
+    class JsonWriter final
+    {
+    public:
+        JsonWriter() = default;
+
+        void clear() noexcept
+        {
+            m_buffer.clear();
+            m_needComma = false;
+        }
+
+        std::string_view view() const noexcept { return m_buffer; }
+        size_t size() const noexcept { return m_buffer.size(); }
+
+        void startObject();
+        void endObject();
+        void startArray();
+        void endArray();
+
+        // Writes an object key. The name is escaped.
+        void key(std::string_view name);
+        // Writes an object key that is already escaped and quoted, including the colon.
+        void rawKey(std::string_view fragment);
+
+        void nullValue();
+        void boolValue(bool value);
+        void intValue(int64_t value);
+        void uintValue(uint64_t value);
+        void doubleValue(double value);
+        void stringValue(std::string_view value);
+        // Writes the bytes as a string in the given encoding.
+        void binaryValue(const unsigned char* data, size_t size, BinaryEncoding encoding);
+        // Writes an already serialized JSON value as is.
+        void rawValue(std::string_view json);
+
+        // Appends the JSON escaped form of the UTF-8 string s (without quotes) to out.
+        // Throws std::runtime_error on invalid UTF-8, as nlohmann::json::dump() does.
+        static void escape(std::string& out, std::string_view s);
+
+    private:
+        void separator()
+        {
+            if (m_needComma) {
+                m_buffer.push_back(',');
+            }
+        }
+
+        std::string m_buffer;
+        bool m_needComma = false;
+    };
+
+}
+
+#endif // FB_JSON_WRITER_H
@@ -0,0 +1,86 @@
+#include "MonotonicArena.h"
+
+#include <cstring>
+
+namespace {
+
+size_t alignUp(size_t offset, size_t alignment)
+{
+    return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+} // namespace
+
+namespace FbUtils
+{
+
+    MonotonicArena::MonotonicArena(size_t blockSize)
+        : m_blockSize(blockSize)
+        , m_blocks()
+        , m_current(0)
+        , m_allocated(0)
+    {
+    }
+
+    void* MonotonicArena::allocate(size_t size, size_t alignment)
+    {
+        if (m_current < m_blocks.size()) {
+            auto& block = m_blocks[m_current];
+            // blocks are aligned to max_align_t, so aligning the offset is enough
+            const auto offset = alignUp(block.used, alignment);
+            if (offset + size <= block.size) {
+                m_allocated += offset + size - block.used;
+                block.used = offset + size;
+                return block.data.get() + offset;
+            }
+        }
+        return allocateSlow(size, alignment);
+    }
+
+    // Moves to the next block. A block that is too small for the request is replaced
+    // by one of the required size.
+    void* MonotonicArena::allocateSlow(size_t size, size_t alignment)
+    {
+        const size_t next = m_blocks.empty() ? 0 : m_current + 1;
+        const size_t required = size + alignment;
+        if (next == m_blocks.size()) {
+            m_blocks.emplace_back();
+        }
+        auto& block = m_blocks[next];
+        if (block.size < required) {
+            const auto blockSize = (required > m_blockSize) ? required : m_blockSize;
+            block.data = std::make_unique<char[]>(blockSize);
+            block.size = blockSize;
+        }
+        block.used = 0;
+        m_current = next;
+        return allocate(size, alignment);
+    }
+
+    std::string_view MonotonicArena::copy(std::string_view s)
+    {
+        auto data = allocateChars(s.size());
+        if (!s.empty()) {
+            memcpy(data, s.data(), s.size());
+        }
+        return std::string_view(data, s.size());
+    }
+
+    void MonotonicArena::reset() noexcept
+    {
+        // the other blocks are cleared when the arena moves to them
+        if (!m_blocks.empty()) {
+            m_blocks[0].used = 0;
+        }
+        m_current = 0;
+        m_allocated = 0;
+    }
+
+    void MonotonicArena::release() noexcept
+    {
+        m_blocks.clear();
+        m_current = 0;
+        m_allocated = 0;
+    }
+
+}
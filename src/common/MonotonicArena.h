@@ -0,0 +1,69 @@
+#pragma once
+#ifndef FB_MONOTONIC_ARENA_H
+#define FB_MONOTONIC_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace FbUtils
+{
+
+    // Bump allocator. Memory is taken from large blocks and is never freed one allocation at a time;
+    // reset() makes all of it available again at once. The blocks are kept for reuse.
+    class MonotonicArena final
+    {
+    public:
+        static constexpr size_t DEFAULT_BLOCK_SIZE = 1024 * 1024;
+
+        explicit MonotonicArena(size_t blockSize = DEFAULT_BLOCK_SIZE);
+
+        MonotonicArena(const MonotonicArena&) = delete;
+        MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+        void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+        char* allocateChars(size_t size)
+        {
+            return static_cast<char*>(allocate(size, 1));
+        }
+        // Copies the string into the arena.
+        std::string_view copy(std::string_view s);
+
+        // Forgets all allocations, the memory of the blocks is reused.
+        void reset() noexcept;
+        // Frees the blocks.
+        void release() noexcept;
+
+        // Number of bytes allocated since the last reset, including alignment gaps.
+        size_t size() const noexcept { return m_allocated; }
+
+        // Calls f(const char* data, size_t size) for the used part of each block in allocation order.
+        template <typename F>
+        void forEachBlock(F&& f) const
+        {
+            for (size_t i = 0; i < m_blocks.size() && i <= m_current; i++) {
+                if (m_blocks[i].used > 0) {
+                    f(m_blocks[i].data.get(), m_blocks[i].used);
+                }
+            }
+        }
+
+    private:
+        struct Block {
+            std::unique_ptr<char[]> data;
+            size_t size = 0;
+            size_t used = 0;
+        };
+
+        void* allocateSlow(size_t size, size_t alignment);
+
+        const size_t m_blockSize;
+        std::vector<Block> m_blocks;
+        size_t m_current = 0;
+        size_t m_allocated = 0;
+    };
+
+}
+
+#endif // FB_MONOTONIC_ARENA_H
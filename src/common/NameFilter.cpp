@@ -0,0 +1,79 @@
+#include "NameFilter.h"
+
+#include "Utils.h"
+
+namespace {
+
+// Matches the whole name against a pattern where * is any sequence of characters and ? is one character.
+bool globMatch(std::string_view pattern, std::string_view name) noexcept
+{
+    size_t p = 0, n = 0;
+    // the position after the last * and the name position it was tried at
+    size_t starPattern = std::string_view::npos, starName = 0;
+    while (n < name.size()) {
+        if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n])) {
+            ++p;
+            ++n;
+        } else if (p < pattern.size() && pattern[p] == '*') {
+            starPattern = ++p;
+            starName = n;
+        } else if (starPattern != std::string_view::npos) {
+            // let the last * take one more character
+            p = starPattern;
+            n = ++starName;
+        } else {
+            return false;
+        }
+    }
+    while (p < pattern.size() && pattern[p] == '*') {
+        ++p;
+    }
+    return p == pattern.size();
+}
+
+} // namespace
+
+namespace FbUtils
+{
+
+    NameFilter::NameFilter(std::string_view pattern, NameFilterSyntax syntax)
+        : m_regex(nullptr)
+        , m_names()
+        , m_globs()
+    {
+        if (syntax == NameFilterSyntax::REGEX) {
+            m_regex = std::make_unique<std::regex>(pattern.begin(), pattern.end());
+            return;
+        }
+        while (!pattern.empty()) {
+            const auto pos = pattern.find(',');
+            const auto item = sv_trim(pattern.substr(0, pos));
+            pattern.remove_prefix(pos == std::string_view::npos ? pattern.size() : pos + 1);
+            if (item.empty()) {
+                continue;
+            }
+            if (item.find_first_of("*?") == std::string_view::npos) {
+                m_names.emplace(item);
+            } else {
+                m_globs.emplace_back(item);
+            }
+        }
+    }
+
+    bool NameFilter::match(std::string_view name) const
+    {
+        if (m_regex) {
+            return std::regex_match(name.begin(), name.end(), *m_regex);
+        }
+        if (m_names.find(name) != m_names.end()) {
+            return true;
+        }
+        for (const auto& glob : m_globs) {
+            if (globMatch(glob, name)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+}
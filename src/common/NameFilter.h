@@ -0,0 +1,47 @@
+#pragma once
+#ifndef FB_NAME_FILTER_H
+#define FB_NAME_FILTER_H
+
+#include <functional>
+#include <memory>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace FbUtils
+{
+
+    // Hash for unordered containers with std::string keys that are looked up by std::string_view
+    // without building a temporary string. Used together with std::equal_to<>.
+    struct StringHash {
+        using is_transparent = void;
+
+        size_t operator()(std::string_view s) const noexcept { return std::hash<std::string_view>{}(s); }
+    };
+
+    enum class NameFilterSyntax {
+        REGEX, // an ECMAScript regular expression the whole name must match
+        LIST // comma-separated names, a name may contain the * and ? wildcards
+    };
+
+    // Matches object names, e.g. table names, against a filter.
+    class NameFilter final
+    {
+    public:
+        // Throws std::regex_error if the regular expression is invalid.
+        NameFilter(std::string_view pattern, NameFilterSyntax syntax);
+
+        bool match(std::string_view name) const;
+
+    private:
+        std::unique_ptr<std::regex> m_regex;
+        // names without wildcards
+        std::unordered_set<std::string, StringHash, std::equal_to<>> m_names;
+        std::vector<std::string> m_globs;
+    };
+
+}
+
+#endif // FB_NAME_FILTER_H
@@ -0,0 +1,151 @@
+#include "NumericFormatter.h"
+
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+
+using namespace Firebird;
+
+namespace {
+
+constexpr uint32_t CHUNK_FACTOR = 1000000000;
+constexpr unsigned CHUNK_DIGITS = 9;
+
+// Writes the decimal digits of the 128-bit magnitude to the end of [begin, end),
+// returns the position of the first digit. Zero has no digits.
+char* writeDigits(uint64_t high, uint64_t low, char* begin, char* end) noexcept
+{
+    // 32-bit limbs, the most significant first, divided by 10^9 at a time
+    uint32_t limbs[4] = {
+        static_cast<uint32_t>(high >> 32), static_cast<uint32_t>(high),
+        static_cast<uint32_t>(low >> 32), static_cast<uint32_t>(low)
+    };
+    char* pos = end;
+    while (limbs[0] != 0 || limbs[1] != 0 || limbs[2] != 0 || limbs[3] != 0) {
+        uint64_t remainder = 0;
+        for (auto& limb : limbs) {
+            const uint64_t current = (remainder << 32) | limb;
+            limb = static_cast<uint32_t>(current / CHUNK_FACTOR);
+            remainder = current % CHUNK_FACTOR;
+        }
+        auto chunk = static_cast<uint32_t>(remainder);
+        for (unsigned i = 0; i < CHUNK_DIGITS && pos > begin; i++) {
+            *--pos = static_cast<char>('0' + chunk % 10);
+            chunk /= 10;
+        }
+    }
+    // the last chunk is padded with zeros
+    while (pos < end && *pos == '0') {
+        ++pos;
+    }
+    return pos;
+}
+
+// Writes the sign and the digits with the decimal point placed by the scale, as Firebird does:
+// a decimal point for negative scales, trailing zeros for scales up to 4 and an exponent for other scales.
+// Returns the end of the text.
+char* writeScaled(bool negative, std::string_view number, int scale, char* out, char* end) noexcept
+{
+    if (number.empty()) {
+        number = "0";
+    }
+    if (negative) {
+        *out++ = '-';
+    }
+    if (scale < -38 || scale > 4) {
+        memcpy(out, number.data(), number.size());
+        out += number.size();
+        *out++ = 'E';
+        out = std::to_chars(out, end, scale).ptr;
+    } else if (scale > 0) {
+        memcpy(out, number.data(), number.size());
+        out += number.size();
+        memset(out, '0', static_cast<size_t>(scale));
+        out += scale;
+    } else if (scale < 0) {
+        const auto fraction = static_cast<size_t>(-scale);
+        if (number.size() <= fraction) {
+            // at least one digit before the point
+            *out++ = '0';
+            *out++ = '.';
+            memset(out, '0', fraction - number.size());
+            out += fraction - number.size();
+            memcpy(out, number.data(), number.size());
+            out += number.size();
+        } else {
+            const auto integer = number.size() - fraction;
+            memcpy(out, number.data(), integer);
+            out += integer;
+            *out++ = '.';
+            memcpy(out, number.data() + integer, fraction);
+            out += fraction;
+        }
+    } else {
+        memcpy(out, number.data(), number.size());
+        out += number.size();
+    }
+    return out;
+}
+
+} // namespace
+
+namespace FbUtils
+{
+
+    void NumericFormatter::init(ThrowStatusWrapper* status, IUtil* util)
+    {
+        m_decFloat16 = util->getDecFloat16(status);
+        m_decFloat34 = util->getDecFloat34(status);
+    }
+
+    std::string_view NumericFormatter::formatInt128(const FB_I128& value, int scale, char (&buffer)[INT128_STRING_SIZE]) noexcept
+    {
+        // fb_data[0] holds the low half
+        uint64_t high = value.fb_data[1];
+        uint64_t low = value.fb_data[0];
+        const bool negative = (high >> 63) != 0;
+        if (negative) {
+            // two's complement
+            high = ~high;
+            low = ~low + 1;
+            if (low == 0) {
+                ++high;
+            }
+        }
+
+        char digits[45];
+        const auto digitsEnd = digits + sizeof(digits);
+        const auto digitsBegin = writeDigits(high, low, digits, digitsEnd);
+        const std::string_view number(digitsBegin, static_cast<size_t>(digitsEnd - digitsBegin));
+        const auto end = writeScaled(negative, number, scale, buffer, buffer + INT128_STRING_SIZE);
+        return std::string_view(buffer, static_cast<size_t>(end - buffer));
+    }
+
+    std::string_view NumericFormatter::formatScaledInteger(int64_t value, int scale, char (&buffer)[SCALED_INTEGER_STRING_SIZE]) noexcept
+    {
+        // the magnitude of INT64_MIN does not fit int64_t
+        const bool negative = value < 0;
+        const uint64_t magnitude = negative ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+        char digits[20];
+        const auto digitsEnd = std::to_chars(digits, digits + sizeof(digits), magnitude).ptr;
+        const std::string_view number(digits, static_cast<size_t>(digitsEnd - digits));
+        const auto end = writeScaled(negative, number, scale, buffer, buffer + SCALED_INTEGER_STRING_SIZE);
+        return std::string_view(buffer, static_cast<size_t>(end - buffer));
+    }
+
+    std::string_view NumericFormatter::formatDecFloat16(ThrowStatusWrapper* status, const FB_DEC16& value,
+        char (&buffer)[IDecFloat16::STRING_SIZE]) const
+    {
+        m_decFloat16->toString(status, &value, IDecFloat16::STRING_SIZE, buffer);
+        // the text is null-terminated, the rest of the buffer is not part of it
+        return std::string_view(buffer, strnlen(buffer, IDecFloat16::STRING_SIZE));
+    }
+
+    std::string_view NumericFormatter::formatDecFloat34(ThrowStatusWrapper* status, const FB_DEC34& value,
+        char (&buffer)[IDecFloat34::STRING_SIZE]) const
+    {
+        m_decFloat34->toString(status, &value, IDecFloat34::STRING_SIZE, buffer);
+        return std::string_view(buffer, strnlen(buffer, IDecFloat34::STRING_SIZE));
+    }
+
+}
@@ -0,0 +1,45 @@
+#pragma once
+#ifndef FB_NUMERIC_FORMATTER_H
+#define FB_NUMERIC_FORMATTER_H
+
+#include <cstdint>
+#include <string_view>
+
+#include "firebird/Interface.h"
+
+namespace FbUtils
+{
+
+    // Formats scaled integers, INT128 and DECFLOAT values into caller-provided buffers the same way Firebird does.
+    // The DECFLOAT interfaces are obtained once, integers are formatted without them.
+    class NumericFormatter final
+    {
+    public:
+        // sign, 39 digits, decimal point or exponent
+        static constexpr unsigned INT128_STRING_SIZE = 48;
+        // the text of a scaled integer is never longer, since scales run to -38 before an exponent is used
+        static constexpr unsigned SCALED_INTEGER_STRING_SIZE = INT128_STRING_SIZE;
+
+        NumericFormatter() = default;
+
+        void init(Firebird::ThrowStatusWrapper* status, Firebird::IUtil* util);
+
+        // The same text as IInt128::toString: the digits with a decimal point for negative scales,
+        // trailing zeros for scales up to 4 and an exponent for other scales.
+        static std::string_view formatInt128(const FB_I128& value, int scale, char (&buffer)[INT128_STRING_SIZE]) noexcept;
+        // SMALLINT, INTEGER and BIGINT with a scale, in the same form as formatInt128.
+        static std::string_view formatScaledInteger(int64_t value, int scale, char (&buffer)[SCALED_INTEGER_STRING_SIZE]) noexcept;
+
+        std::string_view formatDecFloat16(Firebird::ThrowStatusWrapper* status, const FB_DEC16& value,
+            char (&buffer)[Firebird::IDecFloat16::STRING_SIZE]) const;
+        std::string_view formatDecFloat34(Firebird::ThrowStatusWrapper* status, const FB_DEC34& value,
+            char (&buffer)[Firebird::IDecFloat34::STRING_SIZE]) const;
+
+    private:
+        Firebird::IDecFloat16* m_decFloat16 = nullptr;
+        Firebird::IDecFloat34* m_decFloat34 = nullptr;
+    };
+
+}
+
+#endif // FB_NUMERIC_FORMATTER_H
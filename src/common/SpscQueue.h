@@ -0,0 +1,77 @@
+#pragma once
+#ifndef FB_SPSC_QUEUE_H
+#define FB_SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace FbUtils
+{
+
+    // Bounded lock-free queue for exactly one producer thread and one consumer thread.
+    // The capacity is rounded up to a power of two.
+    template <typename T>
+    class SpscQueue final
+    {
+    public:
+        explicit SpscQueue(size_t capacity)
+            : m_slots(roundCapacity(capacity))
+            , m_mask(m_slots.size() - 1)
+        {
+        }
+
+        SpscQueue(const SpscQueue&) = delete;
+        SpscQueue& operator=(const SpscQueue&) = delete;
+
+        size_t capacity() const noexcept { return m_slots.size(); }
+
+        // Producer side. Returns false if the queue is full, the value is left untouched then.
+        bool tryPush(T& value)
+        {
+            const auto tail = m_tail.load(std::memory_order_relaxed);
+            if (tail - m_head.load(std::memory_order_acquire) == m_slots.size()) {
+                return false;
+            }
+            m_slots[tail & m_mask] = std::move(value);
+            m_tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer side. Returns false if the queue is empty.
+        bool tryPop(T& value)
+        {
+            const auto head = m_head.load(std::memory_order_relaxed);
+            if (head == m_tail.load(std::memory_order_acquire)) {
+                return false;
+            }
+            value = std::move(m_slots[head & m_mask]);
+            m_head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool empty() const noexcept
+        {
+            return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+        }
+
+    private:
+        static size_t roundCapacity(size_t capacity) noexcept
+        {
+            size_t result = 1;
+            while (result < capacity) {
+                result <<= 1;
+            }
+            return result;
+        }
+
+        std::vector<T> m_slots;
+        const size_t m_mask;
+        // head and tail are kept on separate cache lines, so that the threads do not contend
+        alignas(64) std::atomic<size_t> m_head = 0;
+        alignas(64) std::atomic<size_t> m_tail = 0;
+    };
+
+}
+
+#endif // FB_SPSC_QUEUE_H
@@ -6,6 +6,7 @@
 #include <vector>
 
 #include <stdio.h>
+#include "BinaryEncoding.h"
 #include "FBAutoPtr.h"
 
 using namespace Firebird;
@@ -19,8 +20,6 @@ constexpr char WHITESPACE[] = " \n\r\t\f\v";
 
 constexpr wchar_t WHITESPACE_L[] = L" \n\r\t\f\v";
 
-constexpr const char hex_digits[] = "0123456789ABCDEF";
-
 } // namespace
 
 namespace FbUtils
@@ -126,13 +125,8 @@ namespace FbUtils
 
     std::string binary_to_hex(const unsigned char* data, size_t size)
     {
-        std::string output;
-        output.reserve(size * 2);
-        for (const auto end = data + size; data < end; ++data) {
-            unsigned char c = *data;
-            output.push_back(hex_digits[c >> 4]);
-            output.push_back(hex_digits[c & 15]);
-        }
+        std::string output(hexEncodedSize(size), '\0');
+        encodeHex(data, size, output.data());
         return output;
     }
 
@@ -103,15 +103,6 @@ namespace FbUtils
     std::string getBinaryString(const std::byte* data, size_t length);
     std::wstring getBinaryStringW(const std::byte* data, size_t length);
 
-    template <typename T>
-    std::string getScaledInteger(const T value, short scale)
-    {
-        auto factor = static_cast<T>(NUMERIC_FACTORS[-scale]);
-        auto int_value = value / factor;
-        auto frac_value = value % factor;
-        return vformat("%d.%0*d", int_value, -scale, frac_value);
-    }
-
     bool readBoolFromConfig(Firebird::ThrowStatusWrapper* status, Firebird::IConfig* config, const char* name, bool defaultValue = false);
     int64_t readIntFromConfig(Firebird::ThrowStatusWrapper* status, Firebird::IConfig* config, const char* name, int64_t defaultValue = 0);
     std::string readStringFromConfig(Firebird::ThrowStatusWrapper* status, Firebird::IConfig* config, const char* name, const std::string defaultValue = {});
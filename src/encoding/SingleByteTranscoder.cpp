@@ -0,0 +1,115 @@
+#include "SingleByteTranscoder.h"
+
+#include <bit>
+#include <cstring>
+
+// FB_SINGLE_BYTE_TRANSCODER_NO_SIMD keeps the word check on any CPU, the tests are built with it too
+#if defined(FB_SINGLE_BYTE_TRANSCODER_NO_SIMD)
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define FB_SINGLE_BYTE_TRANSCODER_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FB_SINGLE_BYTE_TRANSCODER_SSE2
+#endif
+
+namespace {
+
+// Returns the number of leading bytes of data below 0x80.
+size_t asciiLength(const char* data, size_t size) noexcept
+{
+    size_t pos = 0;
+#if defined(FB_SINGLE_BYTE_TRANSCODER_AVX2)
+    for (; pos + 32 <= size; pos += 32) {
+        const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+        // the high bit of every byte
+        const auto mask = static_cast<unsigned>(_mm256_movemask_epi8(chunk));
+        if (mask != 0) {
+            return pos + std::countr_zero(mask);
+        }
+    }
+#elif defined(FB_SINGLE_BYTE_TRANSCODER_SSE2)
+    for (; pos + 16 <= size; pos += 16) {
+        const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+        const auto mask = static_cast<unsigned>(_mm_movemask_epi8(chunk));
+        if (mask != 0) {
+            return pos + std::countr_zero(mask);
+        }
+    }
+#else
+    constexpr uint64_t highBits = 0x8080808080808080ULL;
+    for (; pos + 8 <= size; pos += 8) {
+        uint64_t word;
+        memcpy(&word, data + pos, sizeof(word));
+        if ((word & highBits) != 0) {
+            break;
+        }
+    }
+#endif
+    while (pos < size && static_cast<unsigned char>(data[pos]) < 0x80) {
+        ++pos;
+    }
+    return pos;
+}
+
+} // namespace
+
+namespace Firebird {
+
+std::unique_ptr<SingleByteTranscoder> SingleByteTranscoder::create(ThrowStatusWrapper* status, IStringConverter* converter)
+{
+    if (converter->getMinCharSize() != 1 || converter->getMaxCharSize() != 1) {
+        return nullptr;
+    }
+    std::unique_ptr<SingleByteTranscoder> transcoder(new SingleByteTranscoder());
+    for (unsigned c = 0; c < 256; c++) {
+        const char src = static_cast<char>(c);
+        // room for any code point, so that a longer result is noticed
+        char utf8[4];
+        ISC_UINT64 length = 0;
+        try {
+            length = converter->toUtf8(status, &src, 1, utf8, sizeof(utf8));
+        } catch (const FbException&) {
+            // the byte is not defined in the character set
+            status->init();
+            if (c < 0x80) {
+                return nullptr;
+            }
+            continue;
+        }
+        if (length == 0 || length > MAX_UTF8_CHAR_LENGTH || (c < 0x80 && (length != 1 || utf8[0] != src))) {
+            // not a plain single-byte mapping or not ASCII compatible, the converter is used as is
+            return nullptr;
+        }
+        auto& entry = transcoder->m_table[c];
+        entry.length = static_cast<uint8_t>(length);
+        memcpy(entry.bytes, utf8, static_cast<size_t>(length));
+    }
+    return transcoder;
+}
+
+size_t SingleByteTranscoder::toUtf8(const char* src, size_t srcSize, char* destBuffer) const noexcept
+{
+    char* dest = destBuffer;
+    size_t pos = 0;
+    while (pos < srcSize) {
+        // ASCII is the same in UTF-8, runs of it are copied at once
+        const auto ascii = asciiLength(src + pos, srcSize - pos);
+        memcpy(dest, src + pos, ascii);
+        dest += ascii;
+        pos += ascii;
+        // the other bytes up to the next ASCII one go through the table
+        for (; pos < srcSize && static_cast<unsigned char>(src[pos]) >= 0x80; ++pos) {
+            const auto& entry = m_table[static_cast<unsigned char>(src[pos])];
+            if (entry.length == 0) {
+                return UNMAPPED;
+            }
+            // copying all three bytes is cheaper than a variable length copy
+            memcpy(dest, entry.bytes, MAX_UTF8_CHAR_LENGTH);
+            dest += entry.length;
+        }
+    }
+    return static_cast<size_t>(dest - destBuffer);
+}
+
+} // namespace Firebird
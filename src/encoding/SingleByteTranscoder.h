@@ -0,0 +1,43 @@
+#pragma once
+#ifndef SINGLE_BYTE_TRANSCODER_H
+#define SINGLE_BYTE_TRANSCODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "../include/StreamingInterface.h"
+
+namespace Firebird {
+
+// Converts texts of a single-byte character set (WIN125x, ISO8859_x, KOI8, DOS8xx) to UTF-8
+// without the converter. The UTF-8 form of every byte is taken from the converter once.
+class SingleByteTranscoder final {
+public:
+    // UTF-8 bytes of a character of the Basic Multilingual Plane
+    static constexpr size_t MAX_UTF8_CHAR_LENGTH = 3;
+    // returned by toUtf8 for a byte the character set does not define
+    static constexpr size_t UNMAPPED = static_cast<size_t>(-1);
+
+    // Returns nullptr if the character set is not a single-byte one.
+    static std::unique_ptr<SingleByteTranscoder> create(ThrowStatusWrapper* status, IStringConverter* converter);
+
+    // destBuffer must hold srcSize * MAX_UTF8_CHAR_LENGTH bytes.
+    // Returns the length of the result or UNMAPPED, the converter then reports the error.
+    size_t toUtf8(const char* src, size_t srcSize, char* destBuffer) const noexcept;
+
+private:
+    struct Utf8Char {
+        // 0 for an unmapped byte
+        uint8_t length;
+        char bytes[MAX_UTF8_CHAR_LENGTH];
+    };
+
+    SingleByteTranscoder() = default;
+
+    Utf8Char m_table[256] {};
+};
+
+} // namespace Firebird
+
+#endif // SINGLE_BYTE_TRANSCODER_H
@@ -0,0 +1,28 @@
+#include "StringConverterCache.h"
+
+#include "../common/Utils.h"
+
+namespace Firebird {
+
+using FbUtils::IscRandomStatus;
+
+StringConverterCache::StringConverterCache(const StringEncodeHelper& encoder)
+    : m_encoder(encoder)
+    , m_converters()
+{
+}
+
+StringConverterHelper& StringConverterCache::create(ThrowStatusWrapper* status, unsigned charsetId)
+{
+    if (charsetId >= MAX_CHARSET_COUNT) {
+        auto statusVector = IscRandomStatus::createFmtStatus("Invalid character set id %u", charsetId);
+        throw FbException(status, statusVector);
+    }
+    auto converter = std::make_unique<StringConverterHelper>(m_encoder.getConverterById(status, charsetId));
+    // single-byte character sets are converted by a table
+    converter->buildSingleByteTable(status);
+    m_converters[charsetId] = std::move(converter);
+    return *m_converters[charsetId];
+}
+
+} // namespace Firebird
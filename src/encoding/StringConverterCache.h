@@ -0,0 +1,43 @@
+#pragma once
+#ifndef STRING_CONVERTER_CACHE_H
+#define STRING_CONVERTER_CACHE_H
+
+#include <array>
+#include <memory>
+
+#include "../include/StreamingInterface.h"
+#include "StringConverterHelper.h"
+#include "StringEncodeHelper.h"
+
+namespace Firebird {
+
+// Converters indexed by character set id, created on first use together with the table
+// of a single-byte character set. The references stay valid for the life of the cache.
+class StringConverterCache final {
+public:
+    // character set ids are one byte
+    static constexpr unsigned MAX_CHARSET_COUNT = 256;
+
+    explicit StringConverterCache(const StringEncodeHelper& encoder);
+
+    StringConverterCache(const StringConverterCache&) = delete;
+    StringConverterCache& operator=(const StringConverterCache&) = delete;
+
+    StringConverterHelper& get(ThrowStatusWrapper* status, unsigned charsetId)
+    {
+        if (charsetId < MAX_CHARSET_COUNT && m_converters[charsetId]) {
+            return *m_converters[charsetId];
+        }
+        return create(status, charsetId);
+    }
+
+private:
+    StringConverterHelper& create(ThrowStatusWrapper* status, unsigned charsetId);
+
+    const StringEncodeHelper& m_encoder;
+    std::array<std::unique_ptr<StringConverterHelper>, MAX_CHARSET_COUNT> m_converters;
+};
+
+} // namespace Firebird
+
+#endif // STRING_CONVERTER_CACHE_H
@@ -19,11 +19,13 @@ using FbUtils::IscRandomStatus;
 
 StringConverterHelper::StringConverterHelper(IStringConverter* converter)
     : m_converter(converter)
+    , m_singleByteTable(nullptr)
 {
 }
 
 StringConverterHelper::StringConverterHelper(StringConverterHelper&& converter) noexcept
     : m_converter(converter.m_converter)
+    , m_singleByteTable(std::move(converter.m_singleByteTable))
 {
     converter.m_converter = nullptr;
 }
@@ -32,6 +34,7 @@ StringConverterHelper& StringConverterHelper::operator=(StringConverterHelper&&
 {
     if (this != &r) {
         m_converter = r.m_converter;
+        m_singleByteTable = std::move(r.m_singleByteTable);
         r.m_converter = nullptr;
     }
 
@@ -69,9 +72,21 @@ IStringConverter* StringConverterHelper::getStringConverter() const
     return m_converter;
 }
 
+void StringConverterHelper::buildSingleByteTable(ThrowStatusWrapper* status)
+{
+    m_singleByteTable = SingleByteTranscoder::create(status, m_converter);
+}
+
 size_t StringConverterHelper::toUtf8(ThrowStatusWrapper* status, const char* src, size_t srcSize,
     char* destBuffer, size_t destBufferSize) const
 {
+    if (m_singleByteTable && destBufferSize / SingleByteTranscoder::MAX_UTF8_CHAR_LENGTH >= srcSize) {
+        const auto length = m_singleByteTable->toUtf8(src, srcSize, destBuffer);
+        if (length != SingleByteTranscoder::UNMAPPED) {
+            return length;
+        }
+        // the converter reports the undefined character
+    }
     return static_cast<size_t>(m_converter->toUtf8(
         status,
         src,
@@ -157,9 +172,14 @@ size_t StringConverterHelper::fromWCS(ThrowStatusWrapper* status, const wchar_t*
         static_cast<ISC_UINT64>(destBufferSize)));
 }
 
+size_t StringConverterHelper::getUtf8Capacity(size_t srcSize) const
+{
+    return srcSize / m_converter->getMinCharSize() * MAX_UTF8_CP_CHAR;
+}
+
 string StringConverterHelper::toUtf8(ThrowStatusWrapper* status, string_view src) const
 try {
-    size_t resultCapacity = src.size() / m_converter->getMinCharSize() * MAX_UTF8_CP_CHAR;
+    size_t resultCapacity = getUtf8Capacity(src.size());
     string result(resultCapacity, '\0');
     size_t resultLength = toUtf8(status, src.data(), src.size(), result.data(), resultCapacity);
     result.resize(resultLength);
@@ -169,6 +189,43 @@ try {
     throw Firebird::FbException(status, statusVector);
 }
 
+string_view StringConverterHelper::toUtf8(ThrowStatusWrapper* status, string_view src, string& buffer) const
+try {
+    size_t resultCapacity = getUtf8Capacity(src.size());
+    // the buffer never shrinks, its size is the capacity for the next calls
+    if (buffer.size() < resultCapacity) {
+        buffer.resize(resultCapacity);
+    }
+    size_t resultLength = toUtf8(status, src.data(), src.size(), buffer.data(), resultCapacity);
+    return string_view(buffer.data(), resultLength);
+} catch (const std::exception& e) {
+    IscRandomStatus statusVector(e);
+    throw Firebird::FbException(status, statusVector);
+}
+
+void StringConverterHelper::toUtf8(ThrowStatusWrapper* status, Utf8Conversion* conversions, size_t count, string& buffer)
+try {
+    size_t totalCapacity = 0;
+    for (size_t i = 0; i < count; i++) {
+        totalCapacity += conversions[i].converter->getUtf8Capacity(conversions[i].src.size());
+    }
+    if (buffer.size() < totalCapacity) {
+        buffer.resize(totalCapacity);
+    }
+    // the buffer is not reallocated below, so the results stay valid
+    char* dest = buffer.data();
+    for (size_t i = 0; i < count; i++) {
+        auto& conversion = conversions[i];
+        const auto capacity = conversion.converter->getUtf8Capacity(conversion.src.size());
+        const auto length = conversion.converter->toUtf8(status, conversion.src.data(), conversion.src.size(), dest, capacity);
+        conversion.result = string_view(dest, length);
+        dest += capacity;
+    }
+} catch (const std::exception& e) {
+    IscRandomStatus statusVector(e);
+    throw Firebird::FbException(status, statusVector);
+}
+
 string StringConverterHelper::fromUtf8(ThrowStatusWrapper* status, string_view src) const
 try {
     size_t resultCapacity = src.size() * m_converter->getMaxCharSize();
@@ -2,9 +2,12 @@
 #ifndef STRING_CONVERTER_HELPER_H
 #define STRING_CONVERTER_HELPER_H
 
+#include <memory>
 #include <string>
+#include <string_view>
 
 #include "../include/StreamingInterface.h"
+#include "SingleByteTranscoder.h"
 
 namespace Firebird {
 
@@ -18,6 +21,14 @@ public:
     static constexpr int8_t MAX_UTF32_CP_CHAR = sizeof(char32_t) / sizeof(char32_t);
     static constexpr int8_t MAX_WCS_CP_CHAR = sizeof(char32_t) / sizeof(wchar_t);
 
+    // One text of a batch conversion to UTF-8
+    struct Utf8Conversion {
+        const StringConverterHelper* converter;
+        std::string_view src;
+        // set by the conversion, points into the caller's buffer
+        std::string_view result;
+    };
+
     StringConverterHelper() = delete;
     explicit StringConverterHelper(IStringConverter* converter);
 
@@ -29,6 +40,10 @@ public:
 
     IStringConverter* getStringConverter() const;
 
+    // Builds the table for converting a single-byte character set to UTF-8 without the converter.
+    // Does nothing for other character sets.
+    void buildSingleByteTable(ThrowStatusWrapper* status);
+
     int getMaxCharSize() const;
     int getMinCharSize() const;
     unsigned getCharsetId() const;
@@ -44,6 +59,12 @@ public:
     size_t fromWCS(ThrowStatusWrapper* status, const wchar_t* src, size_t srcSize, char* destBuffer, size_t destBufferSize) const;
 
     std::string toUtf8(ThrowStatusWrapper* status, std::string_view src) const;
+    // Converts into a scratch buffer the caller keeps between calls, so that no memory is allocated
+    // once the buffer is large enough. The result is valid until the buffer is used again.
+    std::string_view toUtf8(ThrowStatusWrapper* status, std::string_view src, std::string& buffer) const;
+    // Converts all texts of the batch into one scratch buffer, each with its own converter.
+    // The buffer is grown at most once per batch.
+    static void toUtf8(ThrowStatusWrapper* status, Utf8Conversion* conversions, size_t count, std::string& buffer);
     std::string fromUtf8(ThrowStatusWrapper* status, std::string_view src) const;
     std::u16string toUtf16(ThrowStatusWrapper* status, std::string_view src) const;
     std::string fromUtf16(ThrowStatusWrapper* status, std::u16string_view src) const;
@@ -53,7 +74,10 @@ public:
     std::string fromWCS(ThrowStatusWrapper* status, std::wstring_view src) const;
 
 private:
+    size_t getUtf8Capacity(size_t srcSize) const;
+
     IStringConverter* m_converter { nullptr };
+    std::unique_ptr<SingleByteTranscoder> m_singleByteTable;
 };
 
 } // namespace Firebird
@@ -0,0 +1,571 @@
+#include "ArrowSegmentWriter.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+#include <arrow/api.h>
+#include <arrow/io/file.h>
+#include <arrow/ipc/writer.h>
+#include <parquet/arrow/writer.h>
+
+#include "../../common/Utils.h"
+
+using namespace Firebird;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+using SimpleJsonPlugin::ColumnarFormat;
+using SimpleJsonPlugin::FieldKind;
+using SimpleJsonPlugin::FieldLayout;
+using SimpleJsonPlugin::RowOperation;
+using SimpleJsonPlugin::vary;
+
+// ISC_DATE counts days from 1858-11-17, Arrow dates count them from 1970-01-01
+constexpr int64_t UNIX_EPOCH_DAYS = 40587;
+constexpr int64_t MICROSECONDS_PER_DAY = 86400LL * 1000000LL;
+// ISC_TIME counts 1/10000 of a second
+constexpr int64_t MICROSECONDS_PER_TIME_UNIT = 100;
+
+// number of leading columns before the table fields
+constexpr int SERVICE_COLUMNS = 2;
+
+// the size of a NULL value in an encoded row
+constexpr uint64_t NULL_VALUE_SIZE = UINT64_MAX;
+// values of an encoded row start at multiples of it, enough for any field type
+constexpr size_t VALUE_ALIGNMENT = sizeof(uint64_t);
+
+void checkArrow(const arrow::Status& status)
+{
+    if (!status.ok()) {
+        FbUtils::raiseError("Arrow error: %s", status.ToString().c_str());
+    }
+}
+
+template <typename T>
+T valueOrRaise(arrow::Result<T>&& result)
+{
+    checkArrow(result.status());
+    return std::move(result).ValueUnsafe();
+}
+
+const char* getOperationName(RowOperation operation)
+{
+    switch (operation) {
+    case RowOperation::INSERTED:
+        return "INSERT";
+    case RowOperation::UPDATED_OLD:
+        return "UPDATE_OLD";
+    case RowOperation::UPDATED_NEW:
+        return "UPDATE_NEW";
+    default:
+        return "DELETE";
+    }
+}
+
+std::shared_ptr<arrow::DataType> getArrowType(const FieldLayout& field)
+{
+    const int32_t scale = -field.scale;
+    switch (field.kind) {
+    case FieldKind::TEXT:
+    case FieldKind::TEXT_CONVERT:
+    case FieldKind::VARYING:
+    case FieldKind::VARYING_CONVERT:
+        return arrow::utf8();
+    case FieldKind::TEXT_BINARY:
+    case FieldKind::VARYING_BINARY:
+        return arrow::binary();
+    case FieldKind::SHORT:
+        return arrow::int16();
+    case FieldKind::SHORT_SCALED:
+        return arrow::decimal128(5, scale);
+    case FieldKind::LONG:
+        return arrow::int32();
+    case FieldKind::LONG_SCALED:
+        return arrow::decimal128(10, scale);
+    case FieldKind::INT64:
+        return arrow::int64();
+    case FieldKind::INT64_SCALED:
+        return arrow::decimal128(19, scale);
+    case FieldKind::INT128:
+        return arrow::decimal128(38, scale);
+    case FieldKind::FLOAT:
+        return arrow::float32();
+    case FieldKind::DOUBLE:
+        return arrow::float64();
+    case FieldKind::TIMESTAMP:
+        return arrow::timestamp(arrow::TimeUnit::MICRO);
+    case FieldKind::DATE:
+        return arrow::date32();
+    case FieldKind::TIME:
+        return arrow::time64(arrow::TimeUnit::MICRO);
+    case FieldKind::TIMESTAMP_TZ:
+        // values are stored in UTC, the original time zone is not kept
+        return arrow::timestamp(arrow::TimeUnit::MICRO, "UTC");
+    case FieldKind::TIME_TZ:
+        // UTC time of day
+        return arrow::time64(arrow::TimeUnit::MICRO);
+    case FieldKind::BOOLEAN:
+        return arrow::boolean();
+    case FieldKind::DEC16:
+    case FieldKind::DEC34:
+    case FieldKind::BLOB:
+        return arrow::utf8();
+    default:
+        // an error is raised only if the field has a value
+        return arrow::null();
+    }
+}
+
+parquet::Compression::type getParquetCompression(FbUtils::Compression compression)
+{
+    switch (compression) {
+    case FbUtils::Compression::GZIP:
+        return parquet::Compression::GZIP;
+    case FbUtils::Compression::ZSTD:
+        return parquet::Compression::ZSTD;
+    default:
+        return parquet::Compression::UNCOMPRESSED;
+    }
+}
+
+int64_t getMicroseconds(ISC_DATE date, ISC_TIME time)
+{
+    return (static_cast<int64_t>(date) - UNIX_EPOCH_DAYS) * MICROSECONDS_PER_DAY
+        + static_cast<int64_t>(time) * MICROSECONDS_PER_TIME_UNIT;
+}
+
+// File names may only contain safe characters, quoted table names can have any.
+std::string getSafeFileName(const std::string& relationName)
+{
+    std::string fileName;
+    fileName.reserve(relationName.size());
+    for (const char c : relationName) {
+        const bool safe = (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '_' || c == '$';
+        fileName.push_back(safe ? c : '_');
+    }
+    return fileName;
+}
+
+size_t alignValueSize(size_t size)
+{
+    return (size + VALUE_ALIGNMENT - 1) / VALUE_ALIGNMENT * VALUE_ALIGNMENT;
+}
+
+// The bytes appendValue reads for the value.
+size_t getValueSize(const FieldLayout& field, const unsigned char* fieldData)
+{
+    switch (field.kind) {
+    case FieldKind::VARYING:
+    case FieldKind::VARYING_BINARY:
+    case FieldKind::VARYING_CONVERT:
+        return sizeof(ISC_USHORT) + reinterpret_cast<const vary*>(fieldData)->vary_length;
+    default:
+        return field.length;
+    }
+}
+
+std::string getTableFileName(const std::string& fileStem, unsigned part, ColumnarFormat format)
+{
+    std::string fileName = fileStem;
+    if (part > 0) {
+        fileName += '.';
+        fileName += std::to_string(part);
+    }
+    fileName += (format == ColumnarFormat::PARQUET) ? ".parquet" : ".arrows";
+    return fileName;
+}
+
+void appendValue(ThrowStatusWrapper* status, const FbUtils::NumericFormatter& numericFormatter, std::string& textBuffer,
+    arrow::ArrayBuilder* builder, const FieldLayout& field, const unsigned char* fieldData)
+{
+    switch (field.kind) {
+    case FieldKind::TEXT: {
+        std::string_view s(reinterpret_cast<const char*>(fieldData), field.length);
+        s = FbUtils::sv_rtrim_char(s, ' ');
+        checkArrow(static_cast<arrow::StringBuilder*>(builder)->Append(s));
+        break;
+    }
+    case FieldKind::TEXT_CONVERT: {
+        std::string_view s(reinterpret_cast<const char*>(fieldData), field.length);
+        s = FbUtils::sv_rtrim_char(s, ' ');
+        const auto utf8Str = field.converter->toUtf8(status, s, textBuffer);
+        checkArrow(static_cast<arrow::StringBuilder*>(builder)->Append(utf8Str));
+        break;
+    }
+    case FieldKind::TEXT_BINARY: {
+        checkArrow(static_cast<arrow::BinaryBuilder*>(builder)->Append(fieldData, static_cast<int32_t>(field.length)));
+        break;
+    }
+    case FieldKind::VARYING: {
+        const auto varchar = reinterpret_cast<const vary*>(fieldData);
+        std::string_view s(varchar->vary_string, varchar->vary_length);
+        checkArrow(static_cast<arrow::StringBuilder*>(builder)->Append(s));
+        break;
+    }
+    case FieldKind::VARYING_CONVERT: {
+        const auto varchar = reinterpret_cast<const vary*>(fieldData);
+        std::string_view s(varchar->vary_string, varchar->vary_length);
+        const auto utf8Str = field.converter->toUtf8(status, s, textBuffer);
+        checkArrow(static_cast<arrow::StringBuilder*>(builder)->Append(utf8Str));
+        break;
+    }
+    case FieldKind::VARYING_BINARY: {
+        const auto varchar = reinterpret_cast<const vary*>(fieldData);
+        checkArrow(static_cast<arrow::BinaryBuilder*>(builder)->Append(fieldData + 2, varchar->vary_length));
+        break;
+    }
+    case FieldKind::SHORT: {
+        const auto value = *reinterpret_cast<const ISC_SHORT*>(fieldData);
+        checkArrow(static_cast<arrow::Int16Builder*>(builder)->Append(value));
+        break;
+    }
+    case FieldKind::LONG: {
+        const auto value = *reinterpret_cast<const ISC_LONG*>(fieldData);
+        checkArrow(static_cast<arrow::Int32Builder*>(builder)->Append(value));
+        break;
+    }
+    case FieldKind::INT64: {
+        const auto value = *reinterpret_cast<const ISC_INT64*>(fieldData);
+        checkArrow(static_cast<arrow::Int64Builder*>(builder)->Append(value));
+        break;
+    }
+    case FieldKind::SHORT_SCALED: {
+        const auto value = *reinterpret_cast<const ISC_SHORT*>(fieldData);
+        checkArrow(static_cast<arrow::Decimal128Builder*>(builder)->Append(arrow::Decimal128(value)));
+        break;
+    }
+    case FieldKind::LONG_SCALED: {
+        const auto value = *reinterpret_cast<const ISC_LONG*>(fieldData);
+        checkArrow(static_cast<arrow::Decimal128Builder*>(builder)->Append(arrow::Decimal128(value)));
+        break;
+    }
+    case FieldKind::INT64_SCALED: {
+        const auto value = *reinterpret_cast<const ISC_INT64*>(fieldData);
+        checkArrow(static_cast<arrow::Decimal128Builder*>(builder)->Append(arrow::Decimal128(value)));
+        break;
+    }
+    case FieldKind::INT128: {
+        const auto value = reinterpret_cast<const FB_I128*>(fieldData);
+        // fb_data[0] holds the low half
+        const arrow::Decimal128 decimal(static_cast<int64_t>(value->fb_data[1]), value->fb_data[0]);
+        checkArrow(static_cast<arrow::Decimal128Builder*>(builder)->Append(decimal));
+        break;
+    }
+    case FieldKind::FLOAT: {
+        const auto value = *reinterpret_cast<const float*>(fieldData);
+        checkArrow(static_cast<arrow::FloatBuilder*>(builder)->Append(value));
+        break;
+    }
+    case FieldKind::DOUBLE: {
+        const auto value = *reinterpret_cast<const double*>(fieldData);
+        checkArrow(static_cast<arrow::DoubleBuilder*>(builder)->Append(value));
+        break;
+    }
+    case FieldKind::TIMESTAMP: {
+        const auto value = reinterpret_cast<const ISC_TIMESTAMP*>(fieldData);
+        const auto micros = getMicroseconds(value->timestamp_date, value->timestamp_time);
+        checkArrow(static_cast<arrow::TimestampBuilder*>(builder)->Append(micros));
+        break;
+    }
+    case FieldKind::DATE: {
+        const auto value = *reinterpret_cast<const ISC_DATE*>(fieldData);
+        const auto days = static_cast<int32_t>(value - UNIX_EPOCH_DAYS);
+        checkArrow(static_cast<arrow::Date32Builder*>(builder)->Append(days));
+        break;
+    }
+    case FieldKind::TIME: {
+        const auto value = *reinterpret_cast<const ISC_TIME*>(fieldData);
+        const auto micros = static_cast<int64_t>(value) * MICROSECONDS_PER_TIME_UNIT;
+        checkArrow(static_cast<arrow::Time64Builder*>(builder)->Append(micros));
+        break;
+    }
+    case FieldKind::TIMESTAMP_TZ: {
+        const auto value = reinterpret_cast<const ISC_TIMESTAMP_TZ*>(fieldData);
+        const auto micros = getMicroseconds(value->utc_timestamp.timestamp_date, value->utc_timestamp.timestamp_time);
+        checkArrow(static_cast<arrow::TimestampBuilder*>(builder)->Append(micros));
+        break;
+    }
+    case FieldKind::TIME_TZ: {
+        const auto value = reinterpret_cast<const ISC_TIME_TZ*>(fieldData);
+        const auto micros = static_cast<int64_t>(value->utc_time) * MICROSECONDS_PER_TIME_UNIT;
+        checkArrow(static_cast<arrow::Time64Builder*>(builder)->Append(micros));
+        break;
+    }
+    case FieldKind::BOOLEAN: {
+        const auto value = *reinterpret_cast<const FB_BOOLEAN*>(fieldData);
+        checkArrow(static_cast<arrow::BooleanBuilder*>(builder)->Append(value != 0));
+        break;
+    }
+    case FieldKind::DEC16: {
+        const auto value = reinterpret_cast<const FB_DEC16*>(fieldData);
+        char buffer[IDecFloat16::STRING_SIZE];
+        const auto s = numericFormatter.formatDecFloat16(status, *value, buffer);
+        checkArrow(static_cast<arrow::StringBuilder*>(builder)->Append(s.data(), static_cast<int32_t>(s.size())));
+        break;
+    }
+    case FieldKind::DEC34: {
+        const auto value = reinterpret_cast<const FB_DEC34*>(fieldData);
+        char buffer[IDecFloat34::STRING_SIZE];
+        const auto s = numericFormatter.formatDecFloat34(status, *value, buffer);
+        checkArrow(static_cast<arrow::StringBuilder*>(builder)->Append(s.data(), static_cast<int32_t>(s.size())));
+        break;
+    }
+    case FieldKind::BLOB: {
+        const auto blobId = reinterpret_cast<const ISC_QUAD*>(fieldData);
+        const auto val = FbUtils::vformat("%d:%d", blobId->gds_quad_high, blobId->gds_quad_low);
+        checkArrow(static_cast<arrow::StringBuilder*>(builder)->Append(val));
+        break;
+    }
+    case FieldKind::ARRAY:
+        FbUtils::raiseError("Array is not supported");
+    default:
+        FbUtils::raiseError("Unknown datatype");
+    }
+}
+
+} // namespace
+
+namespace SimpleJsonPlugin {
+
+struct ArrowTableStream {
+    // the record format the stream was created for
+    std::vector<FieldSignature> signature;
+    std::string fileStem;
+    unsigned part = 0;
+    int64_t rows = 0;
+    std::shared_ptr<arrow::Schema> schema;
+    std::unique_ptr<arrow::RecordBatchBuilder> builder;
+    std::shared_ptr<arrow::io::FileOutputStream> file;
+    // one of the writers is used, depending on the format
+    std::shared_ptr<arrow::ipc::RecordBatchWriter> writer;
+    std::unique_ptr<parquet::arrow::FileWriter> parquetWriter;
+};
+
+ArrowSegmentWriter::ArrowSegmentWriter(ColumnarFormat format, const ParquetOptions& parquetOptions, int64_t batchSize)
+    : m_format(format)
+    , m_parquetOptions(parquetOptions)
+    , m_batchSize(batchSize)
+    , m_directory()
+    , m_tempDirectory()
+    , m_metadata()
+    , m_segmentNumber(0)
+    , m_tables()
+    , m_fileStems()
+    , m_textBuffer()
+    , m_rowBuffer()
+{
+}
+
+ArrowSegmentWriter::~ArrowSegmentWriter()
+{
+    abandonSegment();
+}
+
+bool ArrowSegmentWriter::startSegment(const fs::path& directory, const Metadata& metadata)
+{
+    abandonSegment();
+    ++m_segmentNumber;
+    if (fs::exists(directory)) {
+        // the segment has already been processed
+        return false;
+    }
+    m_directory = directory;
+    m_tempDirectory = directory;
+    m_tempDirectory += ".tmp";
+    // leftovers of an interrupted run
+    fs::remove_all(m_tempDirectory);
+    fs::create_directories(m_tempDirectory);
+    m_metadata = metadata;
+    return true;
+}
+
+void ArrowSegmentWriter::encodeRecord(const RecordLayout& layout, IStreamedRecord* record, std::string& row)
+{
+    row.clear();
+    for (const auto& fieldLayout : layout.fields) {
+        const auto fieldData = static_cast<const unsigned char*>(record->getField(fieldLayout.index)->getData());
+        if (fieldData == nullptr) {
+            row.append(reinterpret_cast<const char*>(&NULL_VALUE_SIZE), sizeof(NULL_VALUE_SIZE));
+            continue;
+        }
+        const uint64_t size = getValueSize(fieldLayout, fieldData);
+        row.append(reinterpret_cast<const char*>(&size), sizeof(size));
+        row.append(reinterpret_cast<const char*>(fieldData), size);
+        row.resize(alignValueSize(row.size()));
+    }
+}
+
+void ArrowSegmentWriter::appendRecord(ThrowStatusWrapper* status, const FbUtils::NumericFormatter& numericFormatter, RowOperation operation,
+    ISC_INT64 tnxNumber, const RecordLayout& layout, std::string_view row)
+{
+    auto& table = getTableStream(layout);
+    auto builder = table.builder.get();
+
+    // the row comes from a buffer at any offset, the values are read as their types
+    m_rowBuffer.resize(alignValueSize(row.size()) / sizeof(uint64_t));
+    memcpy(m_rowBuffer.data(), row.data(), row.size());
+    auto position = reinterpret_cast<const unsigned char*>(m_rowBuffer.data());
+
+    checkArrow(builder->GetFieldAs<arrow::StringBuilder>(0)->Append(getOperationName(operation)));
+    checkArrow(builder->GetFieldAs<arrow::Int64Builder>(1)->Append(tnxNumber));
+    int column = SERVICE_COLUMNS;
+    for (const auto& fieldLayout : layout.fields) {
+        auto fieldBuilder = builder->GetField(column++);
+        uint64_t size;
+        memcpy(&size, position, sizeof(size));
+        position += sizeof(size);
+        if (size == NULL_VALUE_SIZE) {
+            checkArrow(fieldBuilder->AppendNull());
+            continue;
+        }
+        appendValue(status, numericFormatter, m_textBuffer, fieldBuilder, fieldLayout, position);
+        position += alignValueSize(size);
+    }
+
+    if (++table.rows >= m_batchSize) {
+        writeBatch(table);
+    }
+}
+
+void ArrowSegmentWriter::finishSegment()
+{
+    for (auto& [relationName, tables] : m_tables) {
+        for (auto& table : tables) {
+            writeBatch(*table);
+            closeTableStream(*table);
+        }
+    }
+    m_tables.clear();
+    m_fileStems.clear();
+    fs::rename(m_tempDirectory, m_directory);
+    m_directory.clear();
+    m_tempDirectory.clear();
+}
+
+void ArrowSegmentWriter::abandonSegment() noexcept
+{
+    for (auto& [relationName, tables] : m_tables) {
+        for (auto& table : tables) {
+            if (table->file) {
+                // errors do not matter, the files are incomplete anyway
+                (void)table->file->Close();
+            }
+        }
+    }
+    m_tables.clear();
+    m_fileStems.clear();
+    m_directory.clear();
+    m_tempDirectory.clear();
+}
+
+ArrowSegmentWriter::TableStream& ArrowSegmentWriter::getTableStream(const RecordLayout& layout)
+{
+    if (layout.columnarStream && layout.columnarSegment == m_segmentNumber) {
+        return *layout.columnarStream;
+    }
+    auto& tables = m_tables[layout.relationName];
+    for (auto& table : tables) {
+        if (table->signature == layout.signature) {
+            layout.columnarStream = table.get();
+            layout.columnarSegment = m_segmentNumber;
+            return *table;
+        }
+    }
+
+    // The table format has changed within the segment. A stream has a single schema,
+    // so the rows of each format go to their own file. The streams stay open,
+    // an update can have the old record in one format and the new one in another.
+    auto table = std::make_unique<TableStream>();
+    table->signature = layout.signature;
+    table->fileStem = tables.empty() ? getTableFileStem(layout.relationName) : tables.front()->fileStem;
+    table->part = static_cast<unsigned>(tables.size());
+
+    arrow::FieldVector fields;
+    fields.reserve(layout.fields.size() + SERVICE_COLUMNS);
+    fields.push_back(arrow::field("operation", arrow::utf8(), false));
+    fields.push_back(arrow::field("tnx", arrow::int64(), false));
+    for (const auto& fieldLayout : layout.fields) {
+        fields.push_back(arrow::field(fieldLayout.name, getArrowType(fieldLayout)));
+    }
+    auto metadata = std::make_shared<arrow::KeyValueMetadata>();
+    for (const auto& [key, value] : m_metadata) {
+        metadata->Append(key, value);
+    }
+    metadata->Append("table", layout.relationName);
+    table->schema = arrow::schema(std::move(fields), std::move(metadata));
+    table->builder = valueOrRaise(arrow::RecordBatchBuilder::Make(table->schema, arrow::default_memory_pool()));
+
+    const auto fileName = m_tempDirectory / getTableFileName(table->fileStem, table->part, m_format);
+    table->file = valueOrRaise(arrow::io::FileOutputStream::Open(fileName.string()));
+    if (m_format == ColumnarFormat::PARQUET) {
+        parquet::WriterProperties::Builder properties;
+        properties.max_row_group_length(m_parquetOptions.rowGroupSize);
+        if (m_parquetOptions.dictionary) {
+            properties.enable_dictionary();
+        } else {
+            properties.disable_dictionary();
+        }
+        properties.compression(getParquetCompression(m_parquetOptions.compression));
+        if (m_parquetOptions.compressionLevel > 0) {
+            properties.compression_level(m_parquetOptions.compressionLevel);
+        }
+        // keeps the Arrow types that Parquet has no exact equivalent for, e.g. the time zone of timestamps
+        parquet::ArrowWriterProperties::Builder arrowProperties;
+        arrowProperties.store_schema();
+        table->parquetWriter = valueOrRaise(parquet::arrow::FileWriter::Open(*table->schema, arrow::default_memory_pool(),
+            table->file, properties.build(), arrowProperties.build()));
+    } else {
+        table->writer = valueOrRaise(arrow::ipc::MakeStreamWriter(table->file, table->schema));
+    }
+
+    layout.columnarStream = table.get();
+    layout.columnarSegment = m_segmentNumber;
+    tables.push_back(std::move(table));
+    return *tables.back();
+}
+
+std::string ArrowSegmentWriter::getTableFileStem(const std::string& relationName)
+{
+    // "A B" and "A_B" would share a file, the later table gets a number
+    const auto safeName = getSafeFileName(relationName);
+    auto fileStem = safeName;
+    for (unsigned n = 2;; n++) {
+        auto key = fileStem;
+        std::transform(key.begin(), key.end(), key.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        if (m_fileStems.insert(std::move(key)).second) {
+            return fileStem;
+        }
+        // '~' is not in a safe name, so the result cannot be the name of another table
+        fileStem = safeName + "~" + std::to_string(n);
+    }
+}
+
+void ArrowSegmentWriter::writeBatch(TableStream& table)
+{
+    if (table.rows == 0) {
+        return;
+    }
+    const auto batch = valueOrRaise(table.builder->Flush());
+    if (table.parquetWriter) {
+        // the rows are buffered until the row group is full
+        checkArrow(table.parquetWriter->WriteRecordBatch(*batch));
+    } else {
+        checkArrow(table.writer->WriteRecordBatch(*batch));
+    }
+    table.rows = 0;
+}
+
+void ArrowSegmentWriter::closeTableStream(TableStream& table)
+{
+    if (table.parquetWriter) {
+        checkArrow(table.parquetWriter->Close());
+    } else {
+        checkArrow(table.writer->Close());
+    }
+    checkArrow(table.file->Close());
+}
+
+} // namespace SimpleJsonPlugin
@@ -0,0 +1,108 @@
+#pragma once
+#ifndef SIMPLE_JSON_ARROW_SEGMENT_WRITER_H
+#define SIMPLE_JSON_ARROW_SEGMENT_WRITER_H
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "../../include/StreamingInterface.h"
+#include "../../common/CompressedStream.h"
+#include "../../common/NumericFormatter.h"
+#include "RecordLayout.h"
+
+namespace SimpleJsonPlugin {
+
+// The value of the operation column. An update is written as two rows:
+// the old record followed by the new one.
+enum class RowOperation {
+    INSERTED,
+    UPDATED_OLD,
+    UPDATED_NEW,
+    DELETED
+};
+
+enum class ColumnarFormat {
+    ARROW_IPC, // Arrow IPC stream files <TABLE>.arrows
+    PARQUET // Parquet files <TABLE>.parquet
+};
+
+struct ParquetOptions {
+    // maximum number of rows in a row group
+    int64_t rowGroupSize = 1024 * 1024;
+    bool dictionary = true;
+    // compression of column chunks
+    FbUtils::Compression compression = FbUtils::Compression::NONE;
+    // 0 selects the default level of the codec
+    int compressionLevel = 0;
+};
+
+// Writes the record events of a segment as Arrow record batches.
+// Each table gets its own file, its columns are operation, tnx and the table fields.
+// The files of a segment are collected in a directory that gets its final name
+// only when the segment is complete.
+class ArrowSegmentWriter final {
+public:
+    using Metadata = std::vector<std::pair<std::string, std::string>>;
+
+    static constexpr int64_t DEFAULT_BATCH_SIZE = 65536;
+
+    explicit ArrowSegmentWriter(ColumnarFormat format = ColumnarFormat::ARROW_IPC,
+        const ParquetOptions& parquetOptions = ParquetOptions(), int64_t batchSize = DEFAULT_BATCH_SIZE);
+    ~ArrowSegmentWriter();
+
+    ArrowSegmentWriter(const ArrowSegmentWriter&) = delete;
+    ArrowSegmentWriter& operator=(const ArrowSegmentWriter&) = delete;
+
+    // Starts the segment directory. The metadata is stored in the schema of every file.
+    // Returns false if the directory already exists, i.e. the segment has been processed.
+    bool startSegment(const std::filesystem::path& directory, const Metadata& metadata);
+    // Copies the values of the record to row, so that it can be appended when its transaction commits.
+    // Each value is its size, all ones for NULL, and its data padded to 8 bytes.
+    static void encodeRecord(const RecordLayout& layout, Firebird::IStreamedRecord* record, std::string& row);
+    // Appends a row made by encodeRecord with the same layout.
+    void appendRecord(Firebird::ThrowStatusWrapper* status, const FbUtils::NumericFormatter& numericFormatter, RowOperation operation,
+        ISC_INT64 tnxNumber, const RecordLayout& layout, std::string_view row);
+    // Writes the rest of the rows, closes the files and renames the directory.
+    void finishSegment();
+    // Closes the files of an unfinished segment, the directory keeps its temporary name.
+    void abandonSegment() noexcept;
+
+private:
+    using TableStream = ArrowTableStream;
+
+    TableStream& getTableStream(const RecordLayout& layout);
+    // The file name of the table without the part number and extension, unique in the segment.
+    std::string getTableFileStem(const std::string& relationName);
+    void writeBatch(TableStream& table);
+    void closeTableStream(TableStream& table);
+
+    const ColumnarFormat m_format;
+    const ParquetOptions m_parquetOptions;
+    const int64_t m_batchSize;
+    std::filesystem::path m_directory;
+    std::filesystem::path m_tempDirectory;
+    Metadata m_metadata;
+    // Counts the segments. A layout may outlive its segment in a transaction that commits later,
+    // the stream it remembers is only used in the segment it was set in.
+    uint64_t m_segmentNumber;
+    // streams by relation name, one per record format of the table. A layout remembers its stream,
+    // so the record formats are only compared for the first row of each layout.
+    std::unordered_map<std::string, std::vector<std::unique_ptr<TableStream>>> m_tables;
+    // lower case file stems in use, file systems may ignore the case
+    std::unordered_set<std::string> m_fileStems;
+    // scratch buffer for the conversion of texts to UTF-8
+    std::string m_textBuffer;
+    // an encoded row copied to aligned memory, its values are read in place
+    std::vector<uint64_t> m_rowBuffer;
+};
+
+} // namespace SimpleJsonPlugin
+
+#endif // SIMPLE_JSON_ARROW_SEGMENT_WRITER_H
@@ -0,0 +1,85 @@
+#include "RecordLayout.h"
+
+#include <cstring>
+
+using namespace Firebird;
+
+namespace SimpleJsonPlugin {
+
+FieldSignature getFieldSignature(IStreamedField* field)
+{
+    if (!field) {
+        return FieldSignature { false, 0, 0, 0, 0, 0, std::string() };
+    }
+    return FieldSignature {
+        true,
+        field->getType(),
+        field->getSubType(),
+        field->getScale(),
+        field->getLength(),
+        field->getCharSet(),
+        field->getName()
+    };
+}
+
+namespace {
+
+bool hasKnownFields(IStreamedRecord* record, const std::vector<KnownField>& knownFields)
+{
+    if (knownFields.empty()) {
+        return false;
+    }
+    for (unsigned i = 0; i < knownFields.size(); i++) {
+        const auto field = record->getField(i);
+        if (field != knownFields[i].field || (field && field->getName() != knownFields[i].name)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool RecordLayout::matches(IStreamedRecord* record) const
+{
+    if (record->getCount() != fieldCount || record->getRawLength() != rawLength) {
+        return false;
+    }
+    for (const auto& known : knownFields) {
+        if (hasKnownFields(record, known)) {
+            return true;
+        }
+    }
+
+    // compared in place, a FieldSignature of every field would copy the names
+    checkedFields.clear();
+    for (unsigned i = 0; i < fieldCount; i++) {
+        const auto& expected = signature[i];
+        auto field = record->getField(i);
+        if (!field) {
+            if (expected.present) {
+                return false;
+            }
+            checkedFields.push_back({ nullptr, nullptr });
+            continue;
+        }
+        const auto name = field->getName();
+        if (!expected.present
+            || field->getType() != expected.type
+            || field->getSubType() != expected.subType
+            || field->getScale() != expected.scale
+            || field->getLength() != expected.length
+            || field->getCharSet() != expected.charset
+            || strcmp(name, expected.name.c_str()) != 0) {
+            return false;
+        }
+        checkedFields.push_back({ field, name });
+    }
+    if (fieldCount > 0) {
+        knownFields[nextKnownRecord].swap(checkedFields);
+        nextKnownRecord = (nextKnownRecord + 1) % KNOWN_RECORDS;
+    }
+    return true;
+}
+
+} // namespace SimpleJsonPlugin
@@ -0,0 +1,120 @@
+#pragma once
+#ifndef SIMPLE_JSON_RECORD_LAYOUT_H
+#define SIMPLE_JSON_RECORD_LAYOUT_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../../include/StreamingInterface.h"
+#include "../../encoding/StringConverterHelper.h"
+
+namespace SimpleJsonPlugin {
+
+struct vary {
+    unsigned short vary_length;
+    char vary_string[1]; /* CVC: The original declaration used UCHAR. */
+};
+
+// How the value of a field is converted.
+// Resolved once per record format so that the per-record loop only has to read the data.
+enum class FieldKind {
+    TEXT,
+    TEXT_BINARY,
+    TEXT_CONVERT,
+    VARYING,
+    VARYING_BINARY,
+    VARYING_CONVERT,
+    SHORT,
+    SHORT_SCALED,
+    LONG,
+    LONG_SCALED,
+    INT64,
+    INT64_SCALED,
+    INT128,
+    FLOAT,
+    DOUBLE,
+    TIMESTAMP,
+    DATE,
+    TIME,
+    TIMESTAMP_TZ,
+    TIME_TZ,
+    BOOLEAN,
+    DEC16,
+    DEC34,
+    BLOB,
+    ARRAY,
+    UNKNOWN
+};
+
+struct FieldLayout {
+    unsigned index;
+    FieldKind kind;
+    short scale;
+    unsigned length;
+    std::string name;
+    // pre-escaped "NAME": fragment for the direct serializer
+    std::string key;
+    // set for the *_CONVERT kinds only
+    Firebird::StringConverterHelper* converter;
+};
+
+// What the layout of a field was built from
+struct FieldSignature {
+    // false if the record has no field at this position
+    bool present;
+    unsigned type;
+    int subType;
+    int scale;
+    unsigned length;
+    unsigned charset;
+    std::string name;
+
+    bool operator==(const FieldSignature&) const = default;
+};
+
+// A field object of a record that passed the full check
+struct KnownField {
+    Firebird::IStreamedField* field;
+    const char* name;
+};
+
+struct ArrowTableStream;
+
+// Cached description of a table record format. The rows of arrow and parquet output wait
+// for the commit with a reference to their layout, which is shared to outlive the cache.
+struct RecordLayout : std::enable_shared_from_this<RecordLayout> {
+    std::string relationName;
+    unsigned fieldCount;
+    unsigned rawLength;
+    // number of fields of the *_CONVERT kinds
+    unsigned convertCount;
+    std::vector<FieldLayout> fields;
+    // one entry per field position, including the absent ones
+    std::vector<FieldSignature> signature;
+
+    // Field objects of the last records that passed the full check. A record with the same
+    // field objects and name pointers is taken to have the same format, so the check costs
+    // two calls per field instead of seven and a strcmp. Two sets are kept, since an update
+    // passes the old and the new record.
+    static constexpr unsigned KNOWN_RECORDS = 2;
+    mutable std::vector<KnownField> knownFields[KNOWN_RECORDS];
+    mutable unsigned nextKnownRecord = 0;
+    // the fields of the record being checked in full
+    mutable std::vector<KnownField> checkedFields;
+    // The columnar stream the rows of this format go to in segment columnarSegment, set by ArrowSegmentWriter.
+    // The streams live until the end of the segment.
+    mutable ArrowTableStream* columnarStream = nullptr;
+    mutable uint64_t columnarSegment = 0;
+
+    // Returns true if the record has the format the layout was built from.
+    // The length of the record alone does not tell a renamed field or one of another type of the same size.
+    bool matches(Firebird::IStreamedRecord* record) const;
+};
+
+FieldSignature getFieldSignature(Firebird::IStreamedField* field);
+
+} // namespace SimpleJsonPlugin
+
+#endif // SIMPLE_JSON_RECORD_LAYOUT_H
@@ -1,25 +1,40 @@
 #include "SimpleJsonPlugin.h"
 
 #include <atomic>
+#include <cstdint>
 #include <filesystem>
+#include <algorithm>
 #include <fstream>
 #include <list>
-#include <map>
 #include <memory>
-#include <regex>
 #include <set>
 #include <sstream>
 #include <stack>
+#include <unordered_map>
 #include <vector>
 
 #include <nlohmann/json.hpp>
 
+#include "../../common/AsyncFileWriter.h"
+#include "../../common/BinaryEncoding.h"
+#include "../../common/BlobFileWriter.h"
+#include "../../common/BufferedFileWriter.h"
+#include "../../common/CompressedStream.h"
+#include "../../common/DateTimeFormatter.h"
+#include "../../common/EventBuffer.h"
 #include "../../common/FBAutoPtr.h"
-#include "../../common/LazyFactory.h"
+#include "../../common/IntHashMap.h"
+#include "../../common/JsonWriter.h"
+#include "../../common/MonotonicArena.h"
+#include "../../common/NameFilter.h"
+#include "../../common/NumericFormatter.h"
 #include "../../common/Utils.h"
 #include "../../common/charsets.h"
+#include "../../encoding/StringConverterCache.h"
 #include "../../encoding/StringConverterHelper.h"
 #include "../../encoding/StringEncodeHelper.h"
+#include "ArrowSegmentWriter.h"
+#include "RecordLayout.h"
 
 using namespace Firebird;
 
@@ -30,6 +45,27 @@ namespace fs = std::filesystem;
 using nlohmann::ordered_json;
 using FbUtils::IscRandomStatus;
 
+enum class OutputFormat {
+    JSON, // one JSON document per segment
+    NDJSON, // header and every event on a separate line
+    CBOR, // header and every event as length-prefixed CBOR frames
+    MSGPACK, // header and every event as length-prefixed MessagePack frames
+    ARROW, // record events as Arrow IPC streams, a file per table
+    PARQUET // record events as Parquet files, a file per table
+};
+
+inline bool isColumnarFormat(OutputFormat format)
+{
+    return format == OutputFormat::ARROW || format == OutputFormat::PARQUET;
+}
+
+inline bool isBinaryFormat(OutputFormat format)
+{
+    return format == OutputFormat::CBOR || format == OutputFormat::MSGPACK || isColumnarFormat(format);
+}
+
+class SimpleJsonPluginTransaction;
+
 class SimpleJsonStreamPlugin final : public IStreamPluginImpl<SimpleJsonStreamPlugin, ThrowStatusWrapper> {
 public:
     SimpleJsonStreamPlugin() = delete;
@@ -60,28 +96,61 @@ public:
     void log(unsigned level, const char* message) override;
 
     std::string toUtf8(ThrowStatusWrapper* status, unsigned charsetId, std::string_view s);
+    // Converts the non-null fields of the *_CONVERT kinds to UTF-8 in one batch.
+    // Returns the results in the order of the fields, valid until the next call.
+    const StringConverterHelper::Utf8Conversion* convertTexts(ThrowStatusWrapper* status, const RecordLayout& layout, IStreamedRecord* record);
+    const RecordLayout& getRecordLayout(ThrowStatusWrapper* status, const char* relationName, IStreamedRecord* record);
 
     IUtil* getUtil() { return m_util; };
+    const FbUtils::NumericFormatter& getNumericFormatter() const { return m_numericFormatter; }
+    FbUtils::DateTimeFormatter& getDateTimeFormatter() { return m_dateTimeFormatter; }
 
 private:
     friend class SimpleJsonPluginTransaction;
 
+    StringConverterHelper& getConverter(ThrowStatusWrapper* status, unsigned charsetId);
+    // Takes back a disposed transaction for reuse.
+    void recycleTransaction(SimpleJsonPluginTransaction* transaction) noexcept;
+
     IMaster* m_master = nullptr;
     IConfig* m_config = nullptr;
     StringEncodeHelper m_stringEncoder;
     IStreamLogger* m_logger = nullptr;
     IReferenceCounted* m_owner = nullptr;
     std::atomic_int m_refCounter = 0;
-    std::map<ISC_INT64, IStreamedTransaction*> m_transactions;
+    FbUtils::IntHashMap<ISC_INT64, IStreamedTransaction*> m_transactions;
+    // disposed transactions, reused by startTransaction
+    std::vector<SimpleJsonPluginTransaction*> m_transactionPool;
     IAttachment* m_att = nullptr;
     IUtil* m_util = nullptr;
-    std::map<unsigned, StringConverterHelper> m_encodingConverters {};
+    FbUtils::NumericFormatter m_numericFormatter;
+    FbUtils::DateTimeFormatter m_dateTimeFormatter;
+    StringConverterCache m_encodingConverters;
+    // record layouts by relation name, one per record format seen in the segment,
+    // the key points into RecordLayout::relationName of the first one
+    std::unordered_map<std::string_view, std::vector<std::shared_ptr<RecordLayout>>> m_recordLayouts;
+    // scratch space of convertTexts, reused for every record
+    std::vector<StringConverterHelper::Utf8Conversion> m_textConversions;
+    std::string m_textBuffer;
     SegmentHeaderInfo m_segmentHeader;
-    std::unique_ptr<std::regex> m_include_tables = nullptr;
-    std::unique_ptr<std::regex> m_exclude_tables = nullptr;
+    std::unique_ptr<FbUtils::NameFilter> m_include_tables = nullptr;
+    std::unique_ptr<FbUtils::NameFilter> m_exclude_tables = nullptr;
+    // matchTable results by relation name, the filters are only evaluated once per table
+    std::unordered_map<std::string, bool, FbUtils::StringHash, std::equal_to<>> m_tableMatches;
     bool m_dumpBlobs = false;
     bool m_registerDDL = true;
     bool m_registerSequence = true;
+    bool m_streamingOutput = false;
+    // events of a transaction are buffered and written together when it commits
+    bool m_transactionGrouping = false;
+    OutputFormat m_outputFormat = OutputFormat::JSON;
+    bool m_directSerializer = false;
+    bool m_asyncWrite = false;
+    unsigned m_writeQueueSize = FbUtils::AsyncFileWriter::DEFAULT_QUEUE_SIZE;
+    FbUtils::Compression m_compression = FbUtils::Compression::NONE;
+    int m_compressionLevel = 0;
+    FbUtils::BinaryEncoding m_binaryEncoding = FbUtils::BinaryEncoding::HEX;
+    ParquetOptions m_parquetOptions;
     fs::path m_outputPath;
 
     class PluginImp;
@@ -91,9 +160,14 @@ private:
 class SimpleJsonPluginTransaction final : public IStreamedTransactionImpl<SimpleJsonPluginTransaction, ThrowStatusWrapper> {
 public:
     SimpleJsonPluginTransaction() = delete;
-    SimpleJsonPluginTransaction(SimpleJsonStreamPlugin* applier, ISC_INT64 number);
+    explicit SimpleJsonPluginTransaction(SimpleJsonStreamPlugin* applier);
     virtual ~SimpleJsonPluginTransaction();
 
+    // Binds the object to a transaction, a disposed object is started again instead of a new one.
+    void start(ISC_INT64 number);
+    // The buffer the events go to, null if they are written as they arrive.
+    FbUtils::EventBuffer* groupedEvents();
+
     // IDisposable implementation
     void dispose() override;
 
@@ -115,16 +189,20 @@ public:
 private:
     SimpleJsonStreamPlugin* m_streamPlugin = nullptr;
     ISC_INT64 m_number = 0;
+    // events waiting for commit if transactionGrouping is on
+    FbUtils::EventBuffer m_events;
+    // layouts of the buffered columnar rows, the next segment or DDL drops them from the cache
+    std::vector<std::shared_ptr<const RecordLayout>> m_layouts;
+
+    void appendColumnarRecord(ThrowStatusWrapper* status, RowOperation operation, const char* name, IStreamedRecord* record);
 };
 
 } // namespace SimpleJsonPlugin
 
 namespace {
 
-struct vary {
-    unsigned short vary_length;
-    char vary_string[1]; /* CVC: The original declaration used UCHAR. */
-};
+using SimpleJsonPlugin::FieldLayout;
+using SimpleJsonPlugin::vary;
 
 constexpr const char* states[] = {
     "free",
@@ -133,202 +211,296 @@ constexpr const char* states[] = {
     "archive"
 };
 
-void dumpRecord(ThrowStatusWrapper* status, SimpleJsonPlugin::SimpleJsonStreamPlugin* applier, IStreamedRecord* record, nlohmann::ordered_json& jRecord)
+// Stores record field values into an ordered_json object.
+class JsonRecordBuilder final {
+public:
+    JsonRecordBuilder(nlohmann::ordered_json& jRecord, FbUtils::BinaryEncoding binaryEncoding)
+        : m_record(jRecord)
+        , m_binaryEncoding(binaryEncoding)
+    {
+    }
+
+    void nullValue(const FieldLayout& field) { m_record[field.name] = nullptr; }
+    void boolValue(const FieldLayout& field, bool value) { m_record[field.name] = value; }
+    void intValue(const FieldLayout& field, int64_t value) { m_record[field.name] = value; }
+    void doubleValue(const FieldLayout& field, double value) { m_record[field.name] = value; }
+    void stringValue(const FieldLayout& field, std::string_view value) { m_record[field.name] = value; }
+    void binaryValue(const FieldLayout& field, const unsigned char* data, size_t size)
+    {
+        m_record[field.name] = FbUtils::encode(data, size, m_binaryEncoding);
+    }
+
+private:
+    nlohmann::ordered_json& m_record;
+    const FbUtils::BinaryEncoding m_binaryEncoding;
+};
+
+// Serializes record field values directly into JSON text
+// and remembers where the value of each field is located.
+class JsonRecordWriter final {
+public:
+    struct FieldValue {
+        std::string_view name;
+        size_t offset;
+        size_t length;
+    };
+
+    void setBinaryEncoding(FbUtils::BinaryEncoding binaryEncoding) { m_binaryEncoding = binaryEncoding; }
+
+    void start()
+    {
+        m_writer.clear();
+        m_fields.clear();
+        m_writer.startObject();
+    }
+
+    void finish()
+    {
+        m_writer.endObject();
+    }
+
+    std::string_view json() const { return m_writer.view(); }
+    const std::vector<FieldValue>& fields() const { return m_fields; }
+
+    std::string_view value(const FieldValue& field) const
+    {
+        return m_writer.view().substr(field.offset, field.length);
+    }
+
+    void nullValue(const FieldLayout& field)
+    {
+        startField(field);
+        m_writer.nullValue();
+        finishField();
+    }
+
+    void boolValue(const FieldLayout& field, bool value)
+    {
+        startField(field);
+        m_writer.boolValue(value);
+        finishField();
+    }
+
+    void intValue(const FieldLayout& field, int64_t value)
+    {
+        startField(field);
+        m_writer.intValue(value);
+        finishField();
+    }
+
+    void doubleValue(const FieldLayout& field, double value)
+    {
+        startField(field);
+        m_writer.doubleValue(value);
+        finishField();
+    }
+
+    void stringValue(const FieldLayout& field, std::string_view value)
+    {
+        startField(field);
+        m_writer.stringValue(value);
+        finishField();
+    }
+
+    void binaryValue(const FieldLayout& field, const unsigned char* data, size_t size)
+    {
+        startField(field);
+        m_writer.binaryValue(data, size, m_binaryEncoding);
+        finishField();
+    }
+
+private:
+    void startField(const FieldLayout& field)
+    {
+        m_writer.rawKey(field.key);
+        m_fields.push_back({ field.name, m_writer.size(), 0 });
+    }
+
+    void finishField()
+    {
+        auto& field = m_fields.back();
+        field.length = m_writer.size() - field.offset;
+    }
+
+    FbUtils::JsonWriter m_writer;
+    std::vector<FieldValue> m_fields;
+    FbUtils::BinaryEncoding m_binaryEncoding = FbUtils::BinaryEncoding::HEX;
+};
+
+template <class RecordSink>
+void dumpRecord(ThrowStatusWrapper* status, SimpleJsonPlugin::SimpleJsonStreamPlugin* applier,
+    const SimpleJsonPlugin::RecordLayout& layout, IStreamedRecord* record, RecordSink& jRecord)
 {
     using FbUtils::IscRandomStatus;
+    using SimpleJsonPlugin::FieldKind;
 
-    for (unsigned i = 0; i < record->getCount(); i++) {
-        auto field = record->getField(i);
-        // For calculated fields, it may return null.
-        if (!field)
-            continue;
-        auto fieldType = field->getType();
-        // auto fieldSubType = field->getSubType();
-        auto fieldCharsetId = field->getCharSet();
-        std::string fieldName(field->getName());
-        auto fieldScale = static_cast<short>(field->getScale());
-        auto fieldLength = field->getLength();
+    // texts in other character sets are converted before the loop, in the order of the fields
+    const StringConverterHelper::Utf8Conversion* convertedText = nullptr;
+    if (layout.convertCount > 0) {
+        convertedText = applier->convertTexts(status, layout, record);
+    }
+
+    for (const auto& fieldLayout : layout.fields) {
+        auto field = record->getField(fieldLayout.index);
         auto fieldData = field->getData();
         if (fieldData == nullptr) {
-            jRecord[fieldName] = nullptr;
-        } else {
-            switch (fieldType) {
-            case SQL_TEXT: {
-                if (fieldCharsetId == CS_BINARY) {
-                    const auto val = FbUtils::binary_to_hex(reinterpret_cast<const unsigned char*>(fieldData), fieldLength);
-                    jRecord[fieldName] = val;
-                } else {
-                    const auto text = reinterpret_cast<const char*>(fieldData);
-                    std::string_view s(text, fieldLength);
-                    s = FbUtils::sv_rtrim_char(s, ' ');
-
-                    if ((fieldCharsetId == CS_UTF8) || (fieldCharsetId == CS_NONE)) {
-                        jRecord[fieldName] = s;
-                    } else {
-                        // character conversion required
-                        const auto utf8Str = applier->toUtf8(status, fieldCharsetId, s);
-                        jRecord[fieldName] = utf8Str;
-                    }
-                }
-                break;
-            }
-            case SQL_VARYING: {
-
-                const auto varchar = reinterpret_cast<const vary*>(fieldData);
-                if (fieldCharsetId == CS_BINARY) {
-                    const auto val = FbUtils::binary_to_hex(reinterpret_cast<const unsigned char*>(fieldData) + 2, varchar->vary_length);
-                    jRecord[fieldName] = val;
-                } else {
-                    std::string_view s(varchar->vary_string, varchar->vary_length);
-                    if ((fieldCharsetId == CS_UTF8) || (fieldCharsetId == CS_NONE)) {
-                        jRecord[fieldName] = s;
-                    } else {
-                        // character conversion required
-                        const auto val = applier->toUtf8(status, fieldCharsetId, s);
-                        jRecord[fieldName] = val;
-                    }
-                }
-                break;
-            }
-            case SQL_SHORT: {
-                const auto value = *reinterpret_cast<const ISC_SHORT*>(fieldData);
-                if (fieldScale == 0) {
-                    jRecord[fieldName] = value;
-                } else {
-                    auto val = FbUtils::getScaledInteger(value, fieldScale);
-                    jRecord[fieldName] = val;
-                }
-                break;
-            }
-            case SQL_LONG: {
-                const auto value = *reinterpret_cast<const ISC_LONG*>(fieldData);
-                if (fieldScale == 0) {
-                    jRecord[fieldName] = static_cast<int32_t>(value);
-                } else {
-                    auto val = FbUtils::getScaledInteger(value, fieldScale);
-                    jRecord[fieldName] = val;
-                }
-                break;
-            }
-            case SQL_INT64: {
-                const auto value = *reinterpret_cast<const ISC_INT64*>(fieldData);
-                if (fieldScale == 0) {
-                    jRecord[fieldName] = static_cast<int64_t>(value);
-                } else {
-                    auto val = FbUtils::getScaledInteger(value, fieldScale);
-                    jRecord[fieldName] = val;
-                }
-                break;
-            }
-            case SQL_INT128: {
-                auto value = reinterpret_cast<const FB_I128*>(fieldData);
-                const auto iInt128 = applier->getUtil()->getInt128(status);
-                char buffer[IInt128::STRING_SIZE] = { ' ' };
-                iInt128->toString(status, value, fieldScale, IInt128::STRING_SIZE, buffer);
-                std::string_view s(buffer);
-                const auto val = FbUtils::sv_rtrim_char(s, ' ');
-                jRecord[fieldName] = val;
-                break;
-            }
-            case SQL_FLOAT: {
-                const auto value = *reinterpret_cast<const float*>(fieldData);
-                jRecord[fieldName] = value;
-                break;
-            }
-            case SQL_DOUBLE:
-                [[fallthrough]];
-            case SQL_D_FLOAT: {
-                const auto value = *reinterpret_cast<const double*>(fieldData);
-                jRecord[fieldName] = value;
-                break;
-            }
-            case SQL_TIMESTAMP: {
-                const auto value = *reinterpret_cast<const ISC_TIMESTAMP*>(fieldData);
-                unsigned year = 0, month = 0, day = 0;
-                unsigned hours = 0, minutes = 0, seconds = 0, fractions = 0;
-                applier->getUtil()->decodeDate(value.timestamp_date, &year, &month, &day);
-                applier->getUtil()->decodeTime(value.timestamp_time, &hours, &minutes, &seconds, &fractions);
-                const auto val = FbUtils::vformat("%04d-%02d-%02d %02d:%02d:%02d.%d", year, month, day, hours, minutes, seconds, fractions);
-                jRecord[fieldName] = val;
-                break;
-            }
-            case SQL_TYPE_DATE: {
-                const auto value = *reinterpret_cast<const ISC_DATE*>(fieldData);
-                unsigned year = 0, month = 0, day = 0;
-                applier->getUtil()->decodeDate(value, &year, &month, &day);
-                const auto val = FbUtils::vformat("%04d-%02d-%02d", year, month, day);
-                jRecord[fieldName] = val;
-                break;
-            }
-            case SQL_TYPE_TIME: {
-                const auto value = *reinterpret_cast<const ISC_TIME*>(fieldData);
-                unsigned hours = 0, minutes = 0, seconds = 0, fractions = 0;
-                applier->getUtil()->decodeTime(value, &hours, &minutes, &seconds, &fractions);
-                const auto val = FbUtils::vformat("%02d:%02d:%02d.%d", hours, minutes, seconds, fractions);
-                jRecord[fieldName] = val;
-                break;
-            }
-            case SQL_TIMESTAMP_TZ: {
-                const auto value = reinterpret_cast<const ISC_TIMESTAMP_TZ*>(fieldData);
-                unsigned year = 0, month = 0, day = 0;
-                unsigned hours = 0, minutes = 0, seconds = 0, fractions = 0;
-                char timezoneBuffer[252] = { '\0' };
-                applier->getUtil()->decodeTimeStampTz(status, value, &year, &month, &day, &hours, &minutes, &seconds, &fractions, 252, timezoneBuffer);
-                const auto val = FbUtils::vformat("%04d-%02d-%02d %02d:%02d:%02d.%d %s", year, month, day, hours, minutes, seconds, fractions, timezoneBuffer);
-                jRecord[fieldName] = val;
-                break;
-            }
-            case SQL_TIME_TZ: {
-                const auto value = reinterpret_cast<const ISC_TIME_TZ*>(fieldData);
-                unsigned hours = 0, minutes = 0, seconds = 0, fractions = 0;
-                char timezoneBuffer[252] = { '\0' };
-                applier->getUtil()->decodeTimeTz(status, value, &hours, &minutes, &seconds, &fractions, 252, timezoneBuffer);
-                const auto val = FbUtils::vformat("%02d:%02d:%02d.%d %s", hours, minutes, seconds, fractions, timezoneBuffer);
-                jRecord[fieldName] = val;
-                break;
-            }
-            case SQL_BOOLEAN: {
-                const auto value = *reinterpret_cast<const FB_BOOLEAN*>(fieldData);
-                const auto val = (value ? true : false);
-                jRecord[fieldName] = val;
-                break;
-            }
-            case SQL_DEC16: {
-                auto value = reinterpret_cast<const FB_DEC16*>(fieldData);
-                const auto iDecFloat16 = applier->getUtil()->getDecFloat16(status);
-                char buffer[IDecFloat16::STRING_SIZE] = { ' ' };
-                iDecFloat16->toString(status, value, IDecFloat16::STRING_SIZE, buffer);
-                std::string_view s(buffer, IDecFloat16::STRING_SIZE);
-                s = FbUtils::sv_rtrim_char(s);
-                jRecord[fieldName] = s;
-                break;
-            }
-            case SQL_DEC34: {
-                auto value = reinterpret_cast<const FB_DEC34*>(fieldData);
-                const auto iDecFloat34 = applier->getUtil()->getDecFloat34(status);
-                char buffer[IDecFloat34::STRING_SIZE] = { ' ' };
-                iDecFloat34->toString(status, value, IDecFloat34::STRING_SIZE, buffer);
-                std::string_view s(buffer, IDecFloat34::STRING_SIZE);
-                s = FbUtils::sv_rtrim_char(s);
-                jRecord[fieldName] = s;
-                break;
-            }
-            case SQL_BLOB: {
-                const auto blobId = reinterpret_cast<const ISC_QUAD*>(fieldData);
-                const auto val = FbUtils::vformat("%d:%d", blobId->gds_quad_high, blobId->gds_quad_low);
-                jRecord[fieldName] = val;
-                break;
-            }
-            case SQL_ARRAY: {
-                IscRandomStatus statusVector("Array is not supported");
-                throw Firebird::FbException(status, statusVector);
-                break;
-            }
-            default: {
-                IscRandomStatus statusVector("Unknown datatype");
-                throw Firebird::FbException(status, statusVector);
-            }
-            }
+            jRecord.nullValue(fieldLayout);
+            continue;
+        }
+        switch (fieldLayout.kind) {
+        case FieldKind::TEXT_BINARY: {
+            jRecord.binaryValue(fieldLayout, reinterpret_cast<const unsigned char*>(fieldData), fieldLayout.length);
+            break;
+        }
+        case FieldKind::TEXT: {
+            const auto text = reinterpret_cast<const char*>(fieldData);
+            std::string_view s(text, fieldLayout.length);
+            s = FbUtils::sv_rtrim_char(s, ' ');
+            jRecord.stringValue(fieldLayout, s);
+            break;
+        }
+        case FieldKind::TEXT_CONVERT: {
+            jRecord.stringValue(fieldLayout, (convertedText++)->result);
+            break;
+        }
+        case FieldKind::VARYING_BINARY: {
+            const auto varchar = reinterpret_cast<const vary*>(fieldData);
+            jRecord.binaryValue(fieldLayout, reinterpret_cast<const unsigned char*>(fieldData) + 2, varchar->vary_length);
+            break;
+        }
+        case FieldKind::VARYING: {
+            const auto varchar = reinterpret_cast<const vary*>(fieldData);
+            std::string_view s(varchar->vary_string, varchar->vary_length);
+            jRecord.stringValue(fieldLayout, s);
+            break;
+        }
+        case FieldKind::VARYING_CONVERT: {
+            jRecord.stringValue(fieldLayout, (convertedText++)->result);
+            break;
+        }
+        case FieldKind::SHORT: {
+            const auto value = *reinterpret_cast<const ISC_SHORT*>(fieldData);
+            jRecord.intValue(fieldLayout, value);
+            break;
+        }
+        case FieldKind::SHORT_SCALED: {
+            const auto value = *reinterpret_cast<const ISC_SHORT*>(fieldData);
+            char buffer[FbUtils::NumericFormatter::SCALED_INTEGER_STRING_SIZE];
+            const auto val = FbUtils::NumericFormatter::formatScaledInteger(value, fieldLayout.scale, buffer);
+            jRecord.stringValue(fieldLayout, val);
+            break;
+        }
+        case FieldKind::LONG: {
+            const auto value = *reinterpret_cast<const ISC_LONG*>(fieldData);
+            jRecord.intValue(fieldLayout, value);
+            break;
+        }
+        case FieldKind::LONG_SCALED: {
+            const auto value = *reinterpret_cast<const ISC_LONG*>(fieldData);
+            char buffer[FbUtils::NumericFormatter::SCALED_INTEGER_STRING_SIZE];
+            const auto val = FbUtils::NumericFormatter::formatScaledInteger(value, fieldLayout.scale, buffer);
+            jRecord.stringValue(fieldLayout, val);
+            break;
+        }
+        case FieldKind::INT64: {
+            const auto value = *reinterpret_cast<const ISC_INT64*>(fieldData);
+            jRecord.intValue(fieldLayout, value);
+            break;
+        }
+        case FieldKind::INT64_SCALED: {
+            const auto value = *reinterpret_cast<const ISC_INT64*>(fieldData);
+            char buffer[FbUtils::NumericFormatter::SCALED_INTEGER_STRING_SIZE];
+            const auto val = FbUtils::NumericFormatter::formatScaledInteger(value, fieldLayout.scale, buffer);
+            jRecord.stringValue(fieldLayout, val);
+            break;
+        }
+        case FieldKind::INT128: {
+            const auto value = reinterpret_cast<const FB_I128*>(fieldData);
+            char buffer[FbUtils::NumericFormatter::INT128_STRING_SIZE];
+            const auto val = FbUtils::NumericFormatter::formatInt128(*value, fieldLayout.scale, buffer);
+            jRecord.stringValue(fieldLayout, val);
+            break;
+        }
+        case FieldKind::FLOAT: {
+            const auto value = *reinterpret_cast<const float*>(fieldData);
+            jRecord.doubleValue(fieldLayout, value);
+            break;
+        }
+        case FieldKind::DOUBLE: {
+            const auto value = *reinterpret_cast<const double*>(fieldData);
+            jRecord.doubleValue(fieldLayout, value);
+            break;
+        }
+        case FieldKind::TIMESTAMP: {
+            const auto value = reinterpret_cast<const ISC_TIMESTAMP*>(fieldData);
+            char buffer[FbUtils::DateTimeFormatter::TIMESTAMP_SIZE];
+            const auto end = applier->getDateTimeFormatter().formatTimestamp(*value, buffer);
+            jRecord.stringValue(fieldLayout, std::string_view(buffer, static_cast<size_t>(end - buffer)));
+            break;
+        }
+        case FieldKind::DATE: {
+            const auto value = *reinterpret_cast<const ISC_DATE*>(fieldData);
+            char buffer[FbUtils::DateTimeFormatter::DATE_SIZE];
+            const auto end = applier->getDateTimeFormatter().formatDate(value, buffer);
+            jRecord.stringValue(fieldLayout, std::string_view(buffer, static_cast<size_t>(end - buffer)));
+            break;
+        }
+        case FieldKind::TIME: {
+            const auto value = *reinterpret_cast<const ISC_TIME*>(fieldData);
+            char buffer[FbUtils::DateTimeFormatter::TIME_SIZE];
+            const auto end = FbUtils::DateTimeFormatter::formatTime(value, buffer);
+            jRecord.stringValue(fieldLayout, std::string_view(buffer, static_cast<size_t>(end - buffer)));
+            break;
+        }
+        case FieldKind::TIMESTAMP_TZ: {
+            const auto value = reinterpret_cast<const ISC_TIMESTAMP_TZ*>(fieldData);
+            char buffer[FbUtils::DateTimeFormatter::TIMESTAMP_TZ_SIZE];
+            const auto end = applier->getDateTimeFormatter().formatTimestampTz(status, *value, buffer);
+            jRecord.stringValue(fieldLayout, std::string_view(buffer, static_cast<size_t>(end - buffer)));
+            break;
+        }
+        case FieldKind::TIME_TZ: {
+            const auto value = reinterpret_cast<const ISC_TIME_TZ*>(fieldData);
+            char buffer[FbUtils::DateTimeFormatter::TIME_TZ_SIZE];
+            const auto end = applier->getDateTimeFormatter().formatTimeTz(status, *value, buffer);
+            jRecord.stringValue(fieldLayout, std::string_view(buffer, static_cast<size_t>(end - buffer)));
+            break;
+        }
+        case FieldKind::BOOLEAN: {
+            const auto value = *reinterpret_cast<const FB_BOOLEAN*>(fieldData);
+            const auto val = (value ? true : false);
+            jRecord.boolValue(fieldLayout, val);
+            break;
+        }
+        case FieldKind::DEC16: {
+            const auto value = reinterpret_cast<const FB_DEC16*>(fieldData);
+            char buffer[IDecFloat16::STRING_SIZE];
+            const auto val = applier->getNumericFormatter().formatDecFloat16(status, *value, buffer);
+            jRecord.stringValue(fieldLayout, val);
+            break;
+        }
+        case FieldKind::DEC34: {
+            const auto value = reinterpret_cast<const FB_DEC34*>(fieldData);
+            char buffer[IDecFloat34::STRING_SIZE];
+            const auto val = applier->getNumericFormatter().formatDecFloat34(status, *value, buffer);
+            jRecord.stringValue(fieldLayout, val);
+            break;
+        }
+        case FieldKind::BLOB: {
+            const auto blobId = reinterpret_cast<const ISC_QUAD*>(fieldData);
+            const auto val = FbUtils::vformat("%d:%d", blobId->gds_quad_high, blobId->gds_quad_low);
+            jRecord.stringValue(fieldLayout, val);
+            break;
+        }
+        case FieldKind::ARRAY: {
+            IscRandomStatus statusVector("Array is not supported");
+            throw Firebird::FbException(status, statusVector);
+            break;
+        }
+        default: {
+            IscRandomStatus statusVector("Unknown datatype");
+            throw Firebird::FbException(status, statusVector);
+        }
         }
     }
 }
@@ -339,13 +511,126 @@ namespace SimpleJsonPlugin {
 
 class SimpleJsonStreamPlugin::PluginImp {
 private:
-    ordered_json doc;
+    ordered_json m_header;
+    // Without streaming the events of the segment are kept as JSON text, already indented
+    // for the "events" array of the document, and released at once when the segment is saved.
+    FbUtils::MonotonicArena m_segmentEvents;
+    // In streaming mode events are written to the file as they arrive
+    // instead of being accumulated in m_segmentEvents.
+    bool m_streaming = false;
+    OutputFormat m_format = OutputFormat::JSON;
+    // current output stream, null if nothing is written for the segment
+    FbUtils::OutputStream* m_writer = nullptr;
+    std::unique_ptr<FbUtils::BufferedFileWriter> m_fileWriter;
+    std::unique_ptr<FbUtils::OutputStream> m_compressor;
+    // if set, files are written by a background thread
+    std::unique_ptr<FbUtils::AsyncFileWriter> m_asyncWriter;
+    FbUtils::Compression m_compression = FbUtils::Compression::NONE;
+    int m_compressionLevel = 0;
+    FbUtils::BinaryEncoding m_binaryEncoding = FbUtils::BinaryEncoding::HEX;
+    // blobs larger than the threshold go to a sidecar file, 0 - never
+    size_t m_blobSpillThreshold = 0;
+    fs::path m_blobFileName;
+    // opened when the first blob of the segment is spilled
+    std::unique_ptr<FbUtils::BlobFileWriter> m_blobWriter;
+    fs::path m_fileName;
+    // the segment file existed when the segment started, it is not written again
+    bool m_segmentProcessed = false;
+    size_t m_eventCount = 0;
+    // With the direct serializer events are written as JSON text without building ordered_json.
+    bool m_direct = false;
+    FbUtils::JsonWriter m_eventWriter;
+    JsonRecordWriter m_orgRecord;
+    JsonRecordWriter m_newRecord;
+    std::vector<std::string_view> m_changedFields;
+    // reusable buffer for binary formats
+    std::vector<std::uint8_t> m_frame;
+#ifdef HAVE_ARROW
+    // columnar output, record events only
+    std::unique_ptr<ArrowSegmentWriter> m_arrowWriter;
+    // scratch buffer for the values of a row
+    std::string m_columnarRow;
+#endif
+    bool m_arrowSegmentStarted = false;
+    // if set, serialized events go here instead of the output
+    FbUtils::EventBuffer* m_eventBuffer = nullptr;
+
+    // indent of the elements of the "events" array in the document
+    static constexpr std::string_view ELEMENT_INDENT = "        ";
+
+    // kinds of the events in the buffer of a grouped transaction
+    static constexpr unsigned SERIALIZED_EVENT = 0;
+    // a blob spilled when the transaction commits, DeferredBlob followed by the blob data
+    static constexpr unsigned DEFERRED_BLOB = 1;
+
+    // a row of arrow or parquet output, ColumnarRow followed by the values from ArrowSegmentWriter::encodeRecord
+    static constexpr unsigned COLUMNAR_ROW = 2;
+
+    struct DeferredBlob {
+        ISC_QUAD blobId;
+        ISC_INT64 tnxNumber;
+    };
+
+    // the transaction keeps the layout until it ends
+    struct ColumnarRow {
+        const RecordLayout* layout;
+        ISC_INT64 tnxNumber;
+        RowOperation operation;
+    };
+
+    void openOutput(const fs::path& fileName);
+    void closeOutput(const fs::path& newName);
+    void writeSerializedEvent(std::string_view event);
+    void storeEvent(std::string_view event);
+    std::string_view encodeFrame(const ordered_json& value);
+    void writeFrame(const ordered_json& value);
+    void writeFrameEvent(std::string_view frame);
+    void writeTransactionEvent(const char* eventName, ISC_INT64 number);
+    void finishBlobFile();
 
 public:
+    // While it exists, the events written go to the buffer of a grouped transaction.
+    class EventRedirect final {
+    public:
+        EventRedirect(PluginImp& imp, FbUtils::EventBuffer* buffer) noexcept
+            : m_imp(imp)
+        {
+            m_imp.m_eventBuffer = buffer;
+        }
+
+        ~EventRedirect()
+        {
+            m_imp.m_eventBuffer = nullptr;
+        }
+
+        EventRedirect(const EventRedirect&) = delete;
+        EventRedirect& operator=(const EventRedirect&) = delete;
+
+    private:
+        PluginImp& m_imp;
+    };
+
     PluginImp();
-    void writeHeader(const SegmentHeaderInfo& headerInfo);
+    void setStreaming(bool streaming);
+    void setOutputFormat(OutputFormat format);
+    void setDirectSerializer(bool direct);
+    void setAsyncWrite(bool asyncWrite, size_t queueSize);
+    void setCompression(FbUtils::Compression compression, int level);
+    void setColumnarOutput(const ParquetOptions& parquetOptions);
+    void setBinaryEncoding(FbUtils::BinaryEncoding binaryEncoding);
+    void setBlobSpillThreshold(size_t threshold) { m_blobSpillThreshold = threshold; }
+    void waitForOutput();
+    bool isDirectSerializer() const { return m_direct; }
+    FbUtils::BinaryEncoding getBinaryEncoding() const { return m_binaryEncoding; }
+    bool isColumnar() const { return isColumnarFormat(m_format); }
+    JsonRecordWriter& getOrgRecordWriter() { return m_orgRecord; }
+    JsonRecordWriter& getNewRecordWriter() { return m_newRecord; }
+
+    void writeHeader(const SegmentHeaderInfo& headerInfo, const fs::path& fileName, const fs::path& blobFileName);
     void writeEvent(const ordered_json& event);
-    void saveToFile(const fs::path& fileName);
+    // Writes the events of a committed transaction one after another.
+    void writeBufferedEvents(ThrowStatusWrapper* status, const FbUtils::NumericFormatter& numericFormatter, const FbUtils::EventBuffer& events);
+    void saveToFile();
 
     void setSequenceEvent(const char* name, ISC_INT64 value);
 
@@ -361,24 +646,146 @@ public:
 
     void storeBlobEvent(ISC_INT64 tnxNumber, ISC_QUAD* blob_id,
         ISC_INT64 length, const unsigned char* data);
+    void spillBlobEvent(ISC_INT64 tnxNumber, ISC_QUAD* blob_id,
+        const unsigned char* data, size_t size);
 
     void insertRecordEvent(ISC_INT64 tnxNumber, const char* name, const ordered_json& record);
     void updateRecordEvent(ISC_INT64 tnxNumber, const char* name, const ordered_json& orgRecord, const ordered_json& newRecord);
     void deleteRecordEvent(ISC_INT64 tnxNumber, const char* name, const ordered_json& record);
+
+    void insertRecordEvent(ISC_INT64 tnxNumber, const char* name, const JsonRecordWriter& record);
+    void updateRecordEvent(ISC_INT64 tnxNumber, const char* name, const JsonRecordWriter& orgRecord, const JsonRecordWriter& newRecord);
+    void deleteRecordEvent(ISC_INT64 tnxNumber, const char* name, const JsonRecordWriter& record);
+
+    // Buffers a row of arrow or parquet output, writeBufferedEvents writes it.
+    void appendColumnarRecord(RowOperation operation, ISC_INT64 tnxNumber, const RecordLayout& layout, IStreamedRecord* record);
 };
 
 SimpleJsonStreamPlugin::PluginImp::PluginImp()
-    : doc()
+    : m_header()
+    , m_segmentEvents()
+    , m_streaming(false)
+    , m_format(OutputFormat::JSON)
+    , m_writer(nullptr)
+    , m_fileWriter(nullptr)
+    , m_compressor(nullptr)
+    , m_asyncWriter(nullptr)
+    , m_compression(FbUtils::Compression::NONE)
+    , m_compressionLevel(0)
+    , m_binaryEncoding(FbUtils::BinaryEncoding::HEX)
+    , m_blobSpillThreshold(0)
+    , m_blobFileName()
+    , m_blobWriter(nullptr)
+    , m_fileName()
+    , m_segmentProcessed(false)
+    , m_eventCount(0)
+    , m_direct(false)
+    , m_eventWriter()
+    , m_orgRecord()
+    , m_newRecord()
+    , m_changedFields()
+    , m_frame()
+#ifdef HAVE_ARROW
+    , m_arrowWriter(nullptr)
+#endif
+    , m_arrowSegmentStarted(false)
+    , m_eventBuffer(nullptr)
 {
 }
 
-void SimpleJsonStreamPlugin::PluginImp::writeHeader(const SegmentHeaderInfo& headerInfo)
+void SimpleJsonStreamPlugin::PluginImp::setStreaming(bool streaming)
 {
-    // reset
-    doc = {};
+    m_streaming = streaming;
+}
 
-    doc["header"] = {};
-    doc["events"] = ordered_json::array();
+void SimpleJsonStreamPlugin::PluginImp::setOutputFormat(OutputFormat format)
+{
+    m_format = format;
+    if (m_format != OutputFormat::JSON) {
+        // NDJSON and binary formats are always written event by event
+        m_streaming = true;
+    }
+}
+
+void SimpleJsonStreamPlugin::PluginImp::setDirectSerializer(bool direct)
+{
+    // the direct serializer produces JSON text only
+    m_direct = direct && !isBinaryFormat(m_format);
+    if (m_direct) {
+        // serialized events are not kept in memory, so they go straight to the file
+        m_streaming = true;
+    }
+}
+
+void SimpleJsonStreamPlugin::PluginImp::setAsyncWrite(bool asyncWrite, size_t queueSize)
+{
+    // the old writer finishes its pending files before it is destroyed
+    m_writer = nullptr;
+    m_asyncWriter = nullptr;
+    if (asyncWrite) {
+        m_asyncWriter = std::make_unique<FbUtils::AsyncFileWriter>(queueSize);
+    }
+}
+
+void SimpleJsonStreamPlugin::PluginImp::setCompression(FbUtils::Compression compression, int level)
+{
+    m_compression = compression;
+    m_compressionLevel = level;
+}
+
+void SimpleJsonStreamPlugin::PluginImp::setColumnarOutput([[maybe_unused]] const ParquetOptions& parquetOptions)
+{
+#ifdef HAVE_ARROW
+    m_arrowWriter = nullptr;
+    if (m_format == OutputFormat::ARROW) {
+        m_arrowWriter = std::make_unique<ArrowSegmentWriter>(ColumnarFormat::ARROW_IPC);
+    } else if (m_format == OutputFormat::PARQUET) {
+        m_arrowWriter = std::make_unique<ArrowSegmentWriter>(ColumnarFormat::PARQUET, parquetOptions);
+    }
+#endif
+}
+
+void SimpleJsonStreamPlugin::PluginImp::setBinaryEncoding(FbUtils::BinaryEncoding binaryEncoding)
+{
+    m_binaryEncoding = binaryEncoding;
+    m_orgRecord.setBinaryEncoding(binaryEncoding);
+    m_newRecord.setBinaryEncoding(binaryEncoding);
+}
+
+void SimpleJsonStreamPlugin::PluginImp::waitForOutput()
+{
+    if (m_asyncWriter) {
+        m_asyncWriter->wait();
+    }
+}
+
+void SimpleJsonStreamPlugin::PluginImp::writeHeader(const SegmentHeaderInfo& headerInfo, const fs::path& fileName, const fs::path& blobFileName)
+{
+    // reset
+    m_header = {};
+    m_segmentEvents.reset();
+    m_blobWriter = nullptr;
+    m_blobFileName = blobFileName;
+    m_writer = nullptr;
+    m_compressor = nullptr;
+    m_fileWriter = nullptr;
+    m_fileName = fileName;
+    m_segmentProcessed = false;
+    m_eventCount = 0;
+
+#ifdef HAVE_ARROW
+    if (isColumnar()) {
+        // only record events are written, so no other output is opened
+        const ArrowSegmentWriter::Metadata metadata {
+            { "version", std::to_string(headerInfo.version) },
+            { "guid", headerInfo.guid },
+            { "sequence", std::to_string(headerInfo.sequence) },
+            { "state", states[headerInfo.state] }
+        };
+        m_arrowSegmentStarted = m_arrowWriter->startSegment(m_fileName, metadata);
+        return;
+    }
+#endif
 
     ordered_json header;
     header["version"] = headerInfo.version;
@@ -386,29 +793,316 @@ void SimpleJsonStreamPlugin::PluginImp::writeHeader(const SegmentHeaderInfo& hea
     header["sequence"] = headerInfo.sequence;
     header["state"] = states[headerInfo.state];
 
-    doc["header"] = header;
+    // checked once here instead of for every spilled blob
+    m_segmentProcessed = fs::exists(m_fileName);
+    if (m_streaming) {
+        if (m_segmentProcessed) {
+            return;
+        }
+        // The file is written under a temporary name and renamed when the segment is complete,
+        // so a half-written file is never mistaken for a processed segment.
+        fs::path tempFileName(m_fileName);
+        tempFileName += ".tmp";
+        openOutput(tempFileName);
+        if (isBinaryFormat(m_format)) {
+            writeFrame({ { "header", header } });
+            return;
+        }
+        m_writer->write(R"({"header":)");
+        m_writer->write(header.dump());
+        if (m_format == OutputFormat::NDJSON) {
+            m_writer->write("}\n");
+        } else {
+            m_writer->write(R"(,"events":[)");
+        }
+        return;
+    }
+
+    m_header = std::move(header);
+}
+
+// Starts writing the file with the configured compression.
+void SimpleJsonStreamPlugin::PluginImp::openOutput(const fs::path& fileName)
+{
+    if (m_asyncWriter) {
+        m_asyncWriter->open(fileName, m_compression, m_compressionLevel);
+        m_writer = m_asyncWriter.get();
+        return;
+    }
+    m_fileWriter = std::make_unique<FbUtils::BufferedFileWriter>(fileName);
+    m_compressor = FbUtils::createCompressedStream(m_compression, m_compressionLevel, *m_fileWriter);
+    m_writer = m_compressor ? m_compressor.get() : m_fileWriter.get();
+}
+
+// Finishes the current file and renames it to newName, if it is not empty.
+void SimpleJsonStreamPlugin::PluginImp::closeOutput(const fs::path& newName)
+{
+    m_writer = nullptr;
+    if (m_asyncWriter) {
+        // closed, synced and renamed by the writer thread. The segment is only finished
+        // when its file is in place, so an error is reported for this segment, not the next one.
+        if (newName.empty())
+            m_asyncWriter->close();
+        else
+            m_asyncWriter->closeAndRename(newName);
+        m_asyncWriter->wait();
+        return;
+    }
+    if (m_compressor) {
+        m_compressor->close();
+        m_compressor = nullptr;
+    }
+    const auto fileName = m_fileWriter->getFileName();
+    m_fileWriter->close();
+    m_fileWriter = nullptr;
+    if (!newName.empty()) {
+        fs::rename(fileName, newName);
+    }
 }
 
 void SimpleJsonStreamPlugin::PluginImp::writeEvent(const ordered_json& event)
 {
-    doc["events"].push_back(event);
+    if (m_streaming) {
+        // a buffered event may be committed in a segment that is written
+        if (!m_writer && !m_eventBuffer) {
+            return;
+        }
+        if (isBinaryFormat(m_format)) {
+            writeFrameEvent(encodeFrame(event));
+        } else {
+            writeSerializedEvent(event.dump());
+        }
+        return;
+    }
+    storeEvent(event.dump(4));
+}
+
+void SimpleJsonStreamPlugin::PluginImp::writeBufferedEvents([[maybe_unused]] ThrowStatusWrapper* status,
+    [[maybe_unused]] const FbUtils::NumericFormatter& numericFormatter, const FbUtils::EventBuffer& events)
+{
+    // the events were buffered in the form the output takes them
+    events.forEach([&](std::string_view event, unsigned kind) {
+        if (kind == COLUMNAR_ROW) {
+#ifdef HAVE_ARROW
+            if (!m_arrowSegmentStarted) {
+                return;
+            }
+            ColumnarRow row;
+            memcpy(&row, event.data(), sizeof(row));
+            m_arrowWriter->appendRecord(status, numericFormatter, row.operation, row.tnxNumber, *row.layout, event.substr(sizeof(row)));
+#endif
+        } else if (kind == DEFERRED_BLOB) {
+            DeferredBlob blob;
+            memcpy(&blob, event.data(), sizeof(blob));
+            const auto data = event.substr(sizeof(blob));
+            spillBlobEvent(blob.tnxNumber, &blob.blobId, reinterpret_cast<const unsigned char*>(data.data()), data.size());
+        } else if (!m_streaming) {
+            storeEvent(event);
+        } else if (isBinaryFormat(m_format)) {
+            writeFrameEvent(event);
+        } else {
+            writeSerializedEvent(event);
+        }
+    });
+}
+
+// Copies the event text into the arena as an element of the "events" array,
+// so that it is nested the same way as in dump(4) of the whole document.
+void SimpleJsonStreamPlugin::PluginImp::storeEvent(std::string_view event)
+{
+    if (m_eventBuffer) {
+        m_eventBuffer->append(event, SERIALIZED_EVENT);
+        return;
+    }
+    const std::string_view separator = (m_eventCount == 0) ? "" : ",\n";
+    const auto lines = static_cast<size_t>(std::count(event.begin(), event.end(), '\n'));
+    const auto size = separator.size() + (lines + 1) * ELEMENT_INDENT.size() + event.size();
+    auto data = m_segmentEvents.allocateChars(size);
+
+    data = std::copy(separator.begin(), separator.end(), data);
+    data = std::copy(ELEMENT_INDENT.begin(), ELEMENT_INDENT.end(), data);
+    for (size_t pos = 0; pos < event.size();) {
+        auto end = event.find('\n', pos);
+        if (end == std::string_view::npos) {
+            data = std::copy(event.begin() + pos, event.end(), data);
+            break;
+        }
+        ++end;
+        data = std::copy(event.begin() + pos, event.begin() + end, data);
+        data = std::copy(ELEMENT_INDENT.begin(), ELEMENT_INDENT.end(), data);
+        pos = end;
+    }
+    ++m_eventCount;
+}
+
+// Encodes the value as a frame: 4-byte little-endian length followed by CBOR or MessagePack data.
+// The frame is valid until the next call.
+std::string_view SimpleJsonStreamPlugin::PluginImp::encodeFrame(const ordered_json& value)
+{
+    m_frame.clear();
+    // reserve room for the length
+    m_frame.resize(4);
+    if (m_format == OutputFormat::CBOR) {
+        ordered_json::to_cbor(value, m_frame);
+    } else {
+        ordered_json::to_msgpack(value, m_frame);
+    }
+    const auto length = m_frame.size() - 4;
+    if (length > UINT32_MAX) {
+        FbUtils::raiseError("Event is too large: %llu bytes", static_cast<unsigned long long>(length));
+    }
+    m_frame[0] = static_cast<std::uint8_t>(length);
+    m_frame[1] = static_cast<std::uint8_t>(length >> 8);
+    m_frame[2] = static_cast<std::uint8_t>(length >> 16);
+    m_frame[3] = static_cast<std::uint8_t>(length >> 24);
+    return std::string_view(reinterpret_cast<const char*>(m_frame.data()), m_frame.size());
+}
+
+void SimpleJsonStreamPlugin::PluginImp::writeFrame(const ordered_json& value)
+{
+    m_writer->write(encodeFrame(value));
+}
+
+void SimpleJsonStreamPlugin::PluginImp::writeFrameEvent(std::string_view frame)
+{
+    if (m_eventBuffer) {
+        m_eventBuffer->append(frame, SERIALIZED_EVENT);
+        return;
+    }
+    if (!m_writer) {
+        return;
+    }
+    m_writer->write(frame);
+    ++m_eventCount;
+}
+
+void SimpleJsonStreamPlugin::PluginImp::writeSerializedEvent(std::string_view event)
+{
+    if (m_eventBuffer) {
+        m_eventBuffer->append(event, SERIALIZED_EVENT);
+        return;
+    }
+    if (!m_writer) {
+        return;
+    }
+    if (m_format == OutputFormat::NDJSON) {
+        m_writer->write(event);
+        m_writer->write("\n");
+    } else {
+        m_writer->write(m_eventCount == 0 ? "\n" : ",\n");
+        m_writer->write(event);
+    }
+    ++m_eventCount;
+}
+
+void SimpleJsonStreamPlugin::PluginImp::writeTransactionEvent(const char* eventName, ISC_INT64 number)
+{
+    if (m_direct) {
+        m_eventWriter.clear();
+        m_eventWriter.startObject();
+        m_eventWriter.key("event");
+        m_eventWriter.stringValue(eventName);
+        m_eventWriter.key("tnx");
+        m_eventWriter.intValue(number);
+        m_eventWriter.endObject();
+
+        writeSerializedEvent(m_eventWriter.view());
+        return;
+    }
+
+    ordered_json jEvent;
+    jEvent["event"] = eventName;
+    jEvent["tnx"] = static_cast<int64_t>(number);
+
+    writeEvent(jEvent);
+}
+
+void SimpleJsonStreamPlugin::PluginImp::finishBlobFile()
+{
+    if (m_blobWriter) {
+        m_blobWriter->finish();
+        m_blobWriter = nullptr;
+    }
 }
 
-void SimpleJsonStreamPlugin::PluginImp::saveToFile(const fs::path& fileName)
+void SimpleJsonStreamPlugin::PluginImp::saveToFile()
 {
-    if (fs::exists(fileName)) {
+#ifdef HAVE_ARROW
+    if (isColumnar()) {
+        if (m_arrowSegmentStarted) {
+            m_arrowSegmentStarted = false;
+            m_arrowWriter->finishSegment();
+        }
         return;
     }
-    std::ofstream o(fileName);
-    o << std::setw(4) << doc << std::endl;
-    o.close();
+#endif
+    if (m_streaming) {
+        if (!m_writer) {
+            return;
+        }
+        if (m_format == OutputFormat::JSON) {
+            m_writer->write("\n]}\n");
+        }
+        // the blobs are complete before the segment file appears
+        finishBlobFile();
+        closeOutput(m_fileName);
+        return;
+    }
+
+    if (!fs::exists(m_fileName)) {
+        finishBlobFile();
+        // the same text as dump(4) of the whole document produces
+        openOutput(m_fileName);
+        m_writer->write("{\n    \"header\": ");
+        const auto header = m_header.dump(4);
+        const std::string_view headerView(header);
+        for (size_t pos = 0; pos < headerView.size();) {
+            auto end = headerView.find('\n', pos);
+            if (end == std::string_view::npos) {
+                m_writer->write(headerView.substr(pos));
+                break;
+            }
+            ++end;
+            m_writer->write(headerView.substr(pos, end - pos));
+            m_writer->write("    ");
+            pos = end;
+        }
+        m_writer->write(",\n    \"events\": ");
+        if (m_eventCount == 0) {
+            m_writer->write("[]");
+        } else {
+            m_writer->write("[\n");
+            m_segmentEvents.forEachBlock([this](const char* data, size_t size) {
+                m_writer->write(data, size);
+            });
+            m_writer->write("\n    ]");
+        }
+        m_writer->write("\n}\n");
+        closeOutput({});
+    }
 
     // reset
-    doc = {};
+    m_header = {};
+    m_segmentEvents.reset();
 }
 
 void SimpleJsonStreamPlugin::PluginImp::setSequenceEvent(const char* name, ISC_INT64 value)
 {
+    if (m_direct) {
+        m_eventWriter.clear();
+        m_eventWriter.startObject();
+        m_eventWriter.key("event");
+        m_eventWriter.stringValue("SET SEQUENCE");
+        m_eventWriter.key("sequence");
+        m_eventWriter.stringValue(name);
+        m_eventWriter.key("value");
+        m_eventWriter.intValue(value);
+        m_eventWriter.endObject();
+
+        writeSerializedEvent(m_eventWriter.view());
+        return;
+    }
+
     ordered_json jEvent;
     jEvent["event"] = "SET SEQUENCE";
     jEvent["sequence"] = name;
@@ -419,69 +1113,56 @@ void SimpleJsonStreamPlugin::PluginImp::setSequenceEvent(const char* name, ISC_I
 
 void SimpleJsonStreamPlugin::PluginImp::startTransactionEvent(ISC_INT64 number)
 {
-    ordered_json jEvent;
-    jEvent["event"] = "START TRANSACTION";
-    jEvent["tnx"] = static_cast<int64_t>(number);
-
-    writeEvent(jEvent);
+    writeTransactionEvent("START TRANSACTION", number);
 }
 
 void SimpleJsonStreamPlugin::PluginImp::prepareTransactionEvent(ISC_INT64 number)
 {
-    ordered_json jEvent;
-    jEvent["event"] = "PREPARE TRANSACTION";
-    jEvent["tnx"] = static_cast<int64_t>(number);
-
-    writeEvent(jEvent);
+    writeTransactionEvent("PREPARE TRANSACTION", number);
 }
 
 void SimpleJsonStreamPlugin::PluginImp::commitEvent(ISC_INT64 number)
 {
-    ordered_json jEvent;
-    jEvent["event"] = "COMMIT";
-    jEvent["tnx"] = static_cast<int64_t>(number);
-
-    writeEvent(jEvent);
+    writeTransactionEvent("COMMIT", number);
 }
 
 void SimpleJsonStreamPlugin::PluginImp::rollbackEvent(ISC_INT64 number)
 {
-    ordered_json jEvent;
-    jEvent["event"] = "ROLLBACK";
-    jEvent["tnx"] = static_cast<int64_t>(number);
-
-    writeEvent(jEvent);
+    writeTransactionEvent("ROLLBACK", number);
 }
 
 void SimpleJsonStreamPlugin::PluginImp::savepointEvent(ISC_INT64 number)
 {
-    ordered_json jEvent;
-    jEvent["event"] = "SAVEPOINT";
-    jEvent["tnx"] = static_cast<int64_t>(number);
-
-    writeEvent(jEvent);
+    writeTransactionEvent("SAVEPOINT", number);
 }
 
 void SimpleJsonStreamPlugin::PluginImp::releaseSavepointEvent(ISC_INT64 number)
 {
-    ordered_json jEvent;
-    jEvent["event"] = "RELEASE SAVEPOINT";
-    jEvent["tnx"] = static_cast<int64_t>(number);
-
-    writeEvent(jEvent);
+    writeTransactionEvent("RELEASE SAVEPOINT", number);
 }
 
 void SimpleJsonStreamPlugin::PluginImp::rollbackSavepointEvent(ISC_INT64 number)
 {
-    ordered_json jEvent;
-    jEvent["event"] = "ROLLBACK SAVEPOINT";
-    jEvent["tnx"] = static_cast<int64_t>(number);
-
-    writeEvent(jEvent);
+    writeTransactionEvent("ROLLBACK SAVEPOINT", number);
 }
 
 void SimpleJsonStreamPlugin::PluginImp::executeSqlEvent(ISC_INT64 tnxNumber, const char* sql)
 {
+    if (m_direct) {
+        m_eventWriter.clear();
+        m_eventWriter.startObject();
+        m_eventWriter.key("event");
+        m_eventWriter.stringValue("EXECUTE SQL");
+        m_eventWriter.key("sql");
+        m_eventWriter.stringValue(sql);
+        m_eventWriter.key("tnx");
+        m_eventWriter.intValue(tnxNumber);
+        m_eventWriter.endObject();
+
+        writeSerializedEvent(m_eventWriter.view());
+        return;
+    }
+
     ordered_json jEvent;
     jEvent["event"] = "EXECUTE SQL";
     jEvent["sql"] = sql;
@@ -494,21 +1175,96 @@ void SimpleJsonStreamPlugin::PluginImp::storeBlobEvent(ISC_INT64 tnxNumber, ISC_
     ISC_INT64 length, const unsigned char* data)
 {
     if ((length > 0) && (data != nullptr)) {
-        auto bData = reinterpret_cast<const std::byte*>(data);
-        std::vector<std::byte> blobData;
-        blobData.insert(blobData.end(), bData, bData + length);
-        auto binary = FbUtils::binary_to_hex(reinterpret_cast<unsigned char*>(blobData.data()), blobData.size());
+        // the blob is encoded straight from the buffer of fb_streaming
+        const auto size = static_cast<size_t>(length);
+        if (m_blobSpillThreshold > 0 && size > m_blobSpillThreshold) {
+            spillBlobEvent(tnxNumber, blob_id, data, size);
+            return;
+        }
+        if (m_direct) {
+            m_eventWriter.clear();
+            m_eventWriter.startObject();
+            m_eventWriter.key("event");
+            m_eventWriter.stringValue("STORE BLOB");
+            m_eventWriter.key("blobId");
+            m_eventWriter.stringValue(FbUtils::vformat("%d:%d", blob_id->gds_quad_high, blob_id->gds_quad_low));
+            m_eventWriter.key("tnx");
+            m_eventWriter.intValue(tnxNumber);
+            m_eventWriter.key("data");
+            m_eventWriter.binaryValue(data, size, m_binaryEncoding);
+            m_eventWriter.endObject();
+
+            writeSerializedEvent(m_eventWriter.view());
+            return;
+        }
 
         ordered_json jEvent;
         jEvent["event"] = "STORE BLOB";
         jEvent["blobId"] = FbUtils::vformat("%d:%d", blob_id->gds_quad_high, blob_id->gds_quad_low);
         jEvent["tnx"] = static_cast<int64_t>(tnxNumber);
-        jEvent["data"] = binary;
+        jEvent["data"] = FbUtils::encode(data, size, m_binaryEncoding);
 
         writeEvent(jEvent);
     }
 }
 
+// Writes the blob into the sidecar file of the segment, the event only refers to it.
+void SimpleJsonStreamPlugin::PluginImp::spillBlobEvent(ISC_INT64 tnxNumber, ISC_QUAD* blob_id,
+    const unsigned char* data, size_t size)
+{
+    if (m_eventBuffer) {
+        // The blob of a grouped transaction is written on commit, into the blob file of the segment
+        // the transaction commits in, next to its event. A rolled back blob is never written.
+        const DeferredBlob blob { *blob_id, tnxNumber };
+        m_eventBuffer->append({ std::string_view(reinterpret_cast<const char*>(&blob), sizeof(blob)),
+            std::string_view(reinterpret_cast<const char*>(data), size) }, DEFERRED_BLOB);
+        return;
+    }
+    if (isColumnar() || m_segmentProcessed) {
+        return;
+    }
+    if (!m_blobWriter) {
+        m_blobWriter = std::make_unique<FbUtils::BlobFileWriter>(m_blobFileName);
+    }
+    const auto location = m_blobWriter->append(data, size);
+    const auto blobFile = m_blobFileName.filename().u8string();
+    const std::string_view blobFileView(reinterpret_cast<const char*>(blobFile.data()), blobFile.size());
+
+    if (m_direct) {
+        m_eventWriter.clear();
+        m_eventWriter.startObject();
+        m_eventWriter.key("event");
+        m_eventWriter.stringValue("STORE BLOB");
+        m_eventWriter.key("blobId");
+        m_eventWriter.stringValue(FbUtils::vformat("%d:%d", blob_id->gds_quad_high, blob_id->gds_quad_low));
+        m_eventWriter.key("tnx");
+        m_eventWriter.intValue(tnxNumber);
+        m_eventWriter.key("file");
+        m_eventWriter.stringValue(blobFileView);
+        m_eventWriter.key("offset");
+        m_eventWriter.uintValue(location.offset);
+        m_eventWriter.key("length");
+        m_eventWriter.uintValue(location.length);
+        m_eventWriter.key("crc32");
+        m_eventWriter.uintValue(location.crc32);
+        m_eventWriter.endObject();
+
+        writeSerializedEvent(m_eventWriter.view());
+        return;
+    }
+
+    ordered_json jEvent;
+    jEvent["event"] = "STORE BLOB";
+    jEvent["blobId"] = FbUtils::vformat("%d:%d", blob_id->gds_quad_high, blob_id->gds_quad_low);
+    jEvent["tnx"] = static_cast<int64_t>(tnxNumber);
+    jEvent["file"] = blobFileView;
+    jEvent["offset"] = location.offset;
+    jEvent["length"] = location.length;
+    jEvent["crc32"] = location.crc32;
+
+    writeEvent(jEvent);
+}
+
 void SimpleJsonStreamPlugin::PluginImp::insertRecordEvent(ISC_INT64 tnxNumber, const char* name, const ordered_json& record)
 {
     ordered_json jEvent;
@@ -557,6 +1313,99 @@ void SimpleJsonStreamPlugin::PluginImp::deleteRecordEvent(ISC_INT64 tnxNumber, c
     writeEvent(jEvent);
 }
 
+void SimpleJsonStreamPlugin::PluginImp::insertRecordEvent(ISC_INT64 tnxNumber, const char* name, const JsonRecordWriter& record)
+{
+    m_eventWriter.clear();
+    m_eventWriter.startObject();
+    m_eventWriter.key("event");
+    m_eventWriter.stringValue("INSERT");
+    m_eventWriter.key("table");
+    m_eventWriter.stringValue(name);
+    m_eventWriter.key("tnx");
+    m_eventWriter.intValue(tnxNumber);
+    m_eventWriter.key("record");
+    m_eventWriter.rawValue(record.json());
+    m_eventWriter.endObject();
+
+    writeSerializedEvent(m_eventWriter.view());
+}
+
+void SimpleJsonStreamPlugin::PluginImp::updateRecordEvent(ISC_INT64 tnxNumber, const char* name, const JsonRecordWriter& orgRecord, const JsonRecordWriter& newRecord)
+{
+    // Values of the same type are serialized identically,
+    // so comparing the JSON text is enough to find changed fields.
+    m_changedFields.clear();
+    const auto& orgFields = orgRecord.fields();
+    const auto& newFields = newRecord.fields();
+    for (size_t i = 0; i < newFields.size(); i++) {
+        const auto& newField = newFields[i];
+        // usually both records have the same format, so try the same position first
+        auto iOldField = orgFields.cend();
+        if (i < orgFields.size() && orgFields[i].name == newField.name) {
+            iOldField = orgFields.cbegin() + i;
+        } else {
+            iOldField = std::find_if(orgFields.cbegin(), orgFields.cend(), [&newField](const auto& field) {
+                return field.name == newField.name;
+            });
+        }
+        if ((iOldField == orgFields.cend()) || (orgRecord.value(*iOldField) != newRecord.value(newField))) {
+            m_changedFields.push_back(newField.name);
+        }
+    }
+    std::sort(m_changedFields.begin(), m_changedFields.end());
+    m_changedFields.erase(std::unique(m_changedFields.begin(), m_changedFields.end()), m_changedFields.end());
+
+    m_eventWriter.clear();
+    m_eventWriter.startObject();
+    m_eventWriter.key("event");
+    m_eventWriter.stringValue("UPDATE");
+    m_eventWriter.key("table");
+    m_eventWriter.stringValue(name);
+    m_eventWriter.key("tnx");
+    m_eventWriter.intValue(tnxNumber);
+    m_eventWriter.key("changedFields");
+    m_eventWriter.startArray();
+    for (const auto& fieldName : m_changedFields) {
+        m_eventWriter.stringValue(fieldName);
+    }
+    m_eventWriter.endArray();
+    m_eventWriter.key("oldRecord");
+    m_eventWriter.rawValue(orgRecord.json());
+    m_eventWriter.key("record");
+    m_eventWriter.rawValue(newRecord.json());
+    m_eventWriter.endObject();
+
+    writeSerializedEvent(m_eventWriter.view());
+}
+
+void SimpleJsonStreamPlugin::PluginImp::deleteRecordEvent(ISC_INT64 tnxNumber, const char* name, const JsonRecordWriter& record)
+{
+    m_eventWriter.clear();
+    m_eventWriter.startObject();
+    m_eventWriter.key("event");
+    m_eventWriter.stringValue("DELETE");
+    m_eventWriter.key("table");
+    m_eventWriter.stringValue(name);
+    m_eventWriter.key("tnx");
+    m_eventWriter.intValue(tnxNumber);
+    m_eventWriter.key("record");
+    m_eventWriter.rawValue(record.json());
+    m_eventWriter.endObject();
+
+    writeSerializedEvent(m_eventWriter.view());
+}
+
+void SimpleJsonStreamPlugin::PluginImp::appendColumnarRecord([[maybe_unused]] RowOperation operation, [[maybe_unused]] ISC_INT64 tnxNumber, [[maybe_unused]] const RecordLayout& layout, [[maybe_unused]] IStreamedRecord* record)
+{
+#ifdef HAVE_ARROW
+    // Columnar output has no transaction events, so the rows always wait for the commit
+    // in the buffer of the transaction. The rows of a rolled back transaction or savepoint are never written.
+    const ColumnarRow row { &layout, tnxNumber, operation };
+    ArrowSegmentWriter::encodeRecord(layout, record, m_columnarRow);
+    m_eventBuffer->append({ std::string_view(reinterpret_cast<const char*>(&row), sizeof(row)), m_columnarRow }, COLUMNAR_ROW);
+#endif
+}
+
 /////////////////////////////////////////
 //
 // SimpleJsonApplierPlugin implementation
@@ -571,15 +1420,30 @@ SimpleJsonStreamPlugin::SimpleJsonStreamPlugin(IMaster* master, IConfig* config,
     , m_owner(nullptr)
     , m_refCounter(0)
     , m_transactions()
+    , m_transactionPool()
     , m_att(nullptr)
     , m_util(master->getUtilInterface())
-    , m_encodingConverters {}
+    , m_encodingConverters(m_stringEncoder)
+    , m_recordLayouts()
+    , m_textConversions()
+    , m_textBuffer()
     , m_segmentHeader()
     , m_include_tables(nullptr)
     , m_exclude_tables(nullptr)
+    , m_tableMatches()
     , m_dumpBlobs(false)
     , m_registerDDL(true)
     , m_registerSequence(true)
+    , m_streamingOutput(false)
+    , m_transactionGrouping(false)
+    , m_outputFormat(OutputFormat::JSON)
+    , m_directSerializer(false)
+    , m_asyncWrite(false)
+    , m_writeQueueSize(FbUtils::AsyncFileWriter::DEFAULT_QUEUE_SIZE)
+    , m_compression(FbUtils::Compression::NONE)
+    , m_compressionLevel(0)
+    , m_binaryEncoding(FbUtils::BinaryEncoding::HEX)
+    , m_parquetOptions()
     , m_outputPath()
     , pImp(std::make_unique<PluginImp>())
 {
@@ -588,6 +1452,9 @@ SimpleJsonStreamPlugin::SimpleJsonStreamPlugin(IMaster* master, IConfig* config,
 
 SimpleJsonStreamPlugin::~SimpleJsonStreamPlugin()
 {
+    for (auto transaction : m_transactionPool) {
+        delete transaction;
+    }
     if (m_att)
         m_att->release();
     if (m_config)
@@ -628,6 +1495,9 @@ FB_BOOLEAN SimpleJsonStreamPlugin::init(ThrowStatusWrapper* status, IAttachment*
     if (m_att)
         m_att->addRef();
 
+    m_numericFormatter.init(status, m_util);
+    m_dateTimeFormatter.init(m_util);
+
     AutoRelease<IConfigEntry> ceDumpBlobs(m_config->find(status, "dumpBlobs"));
     if (ceDumpBlobs) {
         m_dumpBlobs = ceDumpBlobs->getBoolValue();
@@ -643,6 +1513,168 @@ FB_BOOLEAN SimpleJsonStreamPlugin::init(ThrowStatusWrapper* status, IAttachment*
         m_registerSequence = ceSequenceEvents->getBoolValue();
     }
 
+    AutoRelease<IConfigEntry> ceStreamingOutput(m_config->find(status, "streamingOutput"));
+    if (ceStreamingOutput) {
+        m_streamingOutput = ceStreamingOutput->getBoolValue();
+    }
+    pImp->setStreaming(m_streamingOutput);
+
+    AutoRelease<IConfigEntry> ceTransactionGrouping(m_config->find(status, "transactionGrouping"));
+    if (ceTransactionGrouping) {
+        m_transactionGrouping = ceTransactionGrouping->getBoolValue();
+    }
+
+    AutoRelease<IConfigEntry> ceOutputFormat(m_config->find(status, "outputFormat"));
+    if (ceOutputFormat) {
+        const std::string outputFormat = ceOutputFormat->getValue();
+        if (outputFormat == "json") {
+            m_outputFormat = OutputFormat::JSON;
+        } else if (outputFormat == "ndjson") {
+            m_outputFormat = OutputFormat::NDJSON;
+        } else if (outputFormat == "cbor") {
+            m_outputFormat = OutputFormat::CBOR;
+        } else if (outputFormat == "msgpack") {
+            m_outputFormat = OutputFormat::MSGPACK;
+        } else if (outputFormat == "arrow") {
+            m_outputFormat = OutputFormat::ARROW;
+        } else if (outputFormat == "parquet") {
+            m_outputFormat = OutputFormat::PARQUET;
+        } else {
+            const auto message = FbUtils::vformat(R"(Unsupported value "%s" of parameter "outputFormat")", outputFormat.c_str());
+            IscRandomStatus statusVector(message);
+            throw Firebird::FbException(status, statusVector);
+        }
+    }
+#ifndef HAVE_ARROW
+    if (isColumnarFormat(m_outputFormat)) {
+        const auto message = FbUtils::vformat(R"(Value "%s" of parameter "outputFormat" is not supported, the plugin is built without columnar output)",
+            ceOutputFormat->getValue());
+        IscRandomStatus statusVector(message);
+        throw Firebird::FbException(status, statusVector);
+    }
+#endif
+    pImp->setOutputFormat(m_outputFormat);
+    if (isColumnarFormat(m_outputFormat)) {
+        // the files have no transaction events to tell committed rows, only they are written
+        m_transactionGrouping = true;
+    }
+
+    AutoRelease<IConfigEntry> ceSerializer(m_config->find(status, "serializer"));
+    if (ceSerializer) {
+        const std::string serializer = ceSerializer->getValue();
+        if (serializer == "dom") {
+            m_directSerializer = false;
+        } else if (serializer == "direct") {
+            m_directSerializer = true;
+        } else {
+            const auto message = FbUtils::vformat(R"(Unsupported value "%s" of parameter "serializer")", serializer.c_str());
+            IscRandomStatus statusVector(message);
+            throw Firebird::FbException(status, statusVector);
+        }
+    }
+    if (m_directSerializer && isBinaryFormat(m_outputFormat)) {
+        m_logger->warning(R"(The "direct" serializer writes JSON text only, "dom" is used for binary output formats)");
+    }
+    pImp->setDirectSerializer(m_directSerializer);
+
+    AutoRelease<IConfigEntry> ceAsyncWrite(m_config->find(status, "asyncWrite"));
+    if (ceAsyncWrite) {
+        m_asyncWrite = ceAsyncWrite->getBoolValue();
+    }
+
+    AutoRelease<IConfigEntry> ceWriteQueueSize(m_config->find(status, "writeQueueSize"));
+    if (ceWriteQueueSize) {
+        const auto writeQueueSize = ceWriteQueueSize->getIntValue();
+        if (writeQueueSize <= 0 || writeQueueSize > 1024) {
+            const auto message = FbUtils::vformat(R"(Parameter "writeQueueSize" must be between 1 and 1024, got %lld)", static_cast<long long>(writeQueueSize));
+            IscRandomStatus statusVector(message);
+            throw Firebird::FbException(status, statusVector);
+        }
+        m_writeQueueSize = static_cast<unsigned>(writeQueueSize);
+    }
+    pImp->setAsyncWrite(m_asyncWrite, m_writeQueueSize);
+
+    AutoRelease<IConfigEntry> ceCompression(m_config->find(status, "compression"));
+    if (ceCompression) {
+        const std::string compression = ceCompression->getValue();
+        if (compression == "none") {
+            m_compression = FbUtils::Compression::NONE;
+        } else if (compression == "gzip") {
+            m_compression = FbUtils::Compression::GZIP;
+        } else if (compression == "zstd") {
+            m_compression = FbUtils::Compression::ZSTD;
+        } else {
+            const auto message = FbUtils::vformat(R"(Unsupported value "%s" of parameter "compression")", compression.c_str());
+            IscRandomStatus statusVector(message);
+            throw Firebird::FbException(status, statusVector);
+        }
+    }
+
+    AutoRelease<IConfigEntry> ceCompressionLevel(m_config->find(status, "compressionLevel"));
+    if (ceCompressionLevel) {
+        const auto compressionLevel = ceCompressionLevel->getIntValue();
+        // 0 selects the default level of the library
+        const ISC_INT64 maxLevel = (m_compression == FbUtils::Compression::GZIP) ? 9 : 22;
+        if (compressionLevel < 0 || compressionLevel > maxLevel) {
+            const auto message = FbUtils::vformat(R"(Parameter "compressionLevel" must be between 0 and %lld, got %lld)",
+                static_cast<long long>(maxLevel), static_cast<long long>(compressionLevel));
+            IscRandomStatus statusVector(message);
+            throw Firebird::FbException(status, statusVector);
+        }
+        m_compressionLevel = static_cast<int>(compressionLevel);
+    }
+    if (m_outputFormat == OutputFormat::ARROW && m_compression != FbUtils::Compression::NONE) {
+        IscRandomStatus statusVector(R"(Parameter "compression" is not supported for outputFormat = arrow)");
+        throw Firebird::FbException(status, statusVector);
+    }
+    pImp->setCompression(m_compression, m_compressionLevel);
+
+    AutoRelease<IConfigEntry> ceBinaryEncoding(m_config->find(status, "binaryEncoding"));
+    if (ceBinaryEncoding) {
+        const std::string binaryEncoding = ceBinaryEncoding->getValue();
+        if (binaryEncoding == "hex") {
+            m_binaryEncoding = FbUtils::BinaryEncoding::HEX;
+        } else if (binaryEncoding == "base64") {
+            m_binaryEncoding = FbUtils::BinaryEncoding::BASE64;
+        } else {
+            const auto message = FbUtils::vformat(R"(Unsupported value "%s" of parameter "binaryEncoding")", binaryEncoding.c_str());
+            IscRandomStatus statusVector(message);
+            throw Firebird::FbException(status, statusVector);
+        }
+    }
+    pImp->setBinaryEncoding(m_binaryEncoding);
+
+    AutoRelease<IConfigEntry> ceBlobSpillThreshold(m_config->find(status, "blobSpillThreshold"));
+    if (ceBlobSpillThreshold) {
+        const auto blobSpillThreshold = ceBlobSpillThreshold->getIntValue();
+        if (blobSpillThreshold < 0) {
+            const auto message = FbUtils::vformat(R"(Parameter "blobSpillThreshold" must not be negative, got %lld)", static_cast<long long>(blobSpillThreshold));
+            IscRandomStatus statusVector(message);
+            throw Firebird::FbException(status, statusVector);
+        }
+        pImp->setBlobSpillThreshold(static_cast<size_t>(blobSpillThreshold));
+    }
+
+    AutoRelease<IConfigEntry> ceRowGroupSize(m_config->find(status, "parquetRowGroupSize"));
+    if (ceRowGroupSize) {
+        const auto rowGroupSize = ceRowGroupSize->getIntValue();
+        if (rowGroupSize <= 0) {
+            const auto message = FbUtils::vformat(R"(Parameter "parquetRowGroupSize" must be positive, got %lld)", static_cast<long long>(rowGroupSize));
+            IscRandomStatus statusVector(message);
+            throw Firebird::FbException(status, statusVector);
+        }
+        m_parquetOptions.rowGroupSize = rowGroupSize;
+    }
+
+    AutoRelease<IConfigEntry> ceDictionary(m_config->find(status, "parquetDictionary"));
+    if (ceDictionary) {
+        m_parquetOptions.dictionary = ceDictionary->getBoolValue();
+    }
+    // Parquet compresses column chunks itself
+    m_parquetOptions.compression = m_compression;
+    m_parquetOptions.compressionLevel = m_compressionLevel;
+    pImp->setColumnarOutput(m_parquetOptions);
+
     AutoRelease<IConfigEntry> ceOutputDir(m_config->find(status, "outputDir"));
     if (ceOutputDir) {
         m_outputPath.assign(ceOutputDir->getValue());
@@ -655,10 +1687,25 @@ FB_BOOLEAN SimpleJsonStreamPlugin::init(ThrowStatusWrapper* status, IAttachment*
         throw Firebird::FbException(status, statusVector);
     }
 
+    auto tableFilterSyntax = FbUtils::NameFilterSyntax::REGEX;
+    AutoRelease<IConfigEntry> ceTableFilterSyntax(m_config->find(status, "tableFilterSyntax"));
+    if (ceTableFilterSyntax) {
+        const std::string syntax = ceTableFilterSyntax->getValue();
+        if (syntax == "regex") {
+            tableFilterSyntax = FbUtils::NameFilterSyntax::REGEX;
+        } else if (syntax == "list") {
+            tableFilterSyntax = FbUtils::NameFilterSyntax::LIST;
+        } else {
+            const auto message = FbUtils::vformat(R"(Unsupported value "%s" of parameter "tableFilterSyntax")", syntax.c_str());
+            IscRandomStatus statusVector(message);
+            throw Firebird::FbException(status, statusVector);
+        }
+    }
+
     AutoRelease<IConfigEntry> ceIncludeTables(m_config->find(status, "include_tables"));
     if (ceIncludeTables) {
         try {
-            m_include_tables = std::make_unique<std::regex>(ceIncludeTables->getValue());
+            m_include_tables = std::make_unique<FbUtils::NameFilter>(ceIncludeTables->getValue(), tableFilterSyntax);
         } catch (const std::regex_error& e) {
             IscRandomStatus statusVector(e.what());
             throw Firebird::FbException(status, statusVector);
@@ -668,20 +1715,28 @@ FB_BOOLEAN SimpleJsonStreamPlugin::init(ThrowStatusWrapper* status, IAttachment*
     AutoRelease<IConfigEntry> ceExcludeTables(m_config->find(status, "exclude_tables"));
     if (ceExcludeTables) {
         try {
-            m_exclude_tables = std::make_unique<std::regex>(ceExcludeTables->getValue());
+            m_exclude_tables = std::make_unique<FbUtils::NameFilter>(ceExcludeTables->getValue(), tableFilterSyntax);
         } catch (const std::regex_error& e) {
             IscRandomStatus statusVector(e);
             throw Firebird::FbException(status, statusVector);
         }
     }
+    // the filters may have changed
+    m_tableMatches.clear();
 
     return FB_TRUE;
 }
 
-void SimpleJsonStreamPlugin::finish([[maybe_unused]] ThrowStatusWrapper* status)
-{
+void SimpleJsonStreamPlugin::finish(ThrowStatusWrapper* status)
+try {
     m_include_tables = nullptr;
     m_exclude_tables = nullptr;
+    m_tableMatches.clear();
+    // make sure all files are on disk
+    pImp->waitForOutput();
+} catch (const std::exception& e) {
+    IscRandomStatus statusVector(e);
+    throw Firebird::FbException(status, statusVector);
 }
 
 void SimpleJsonStreamPlugin::startSegment(ThrowStatusWrapper* status, SegmentHeaderInfo* segmentHeader)
@@ -693,6 +1748,10 @@ try {
     m_segmentHeader.length = segmentHeader->length;
     memcpy(m_segmentHeader.name, segmentHeader->name, std::size(segmentHeader->name));
     memcpy(m_segmentHeader.guid, segmentHeader->guid, std::size(segmentHeader->guid));
+    // table formats may differ from one segment to another
+    m_recordLayouts.clear();
+    // dates of the previous segment are unlikely to repeat
+    m_dateTimeFormatter.resetCache();
 
     if (m_logger->getLevel() <= IStreamLogger::LEVEL_DEBUG) {
         // if the debug level is set, print the segment header
@@ -712,7 +1771,36 @@ try {
         m_logger->debug(ss.str().c_str());
     }
 
-    pImp->writeHeader(m_segmentHeader);
+    std::string segmentName = m_segmentHeader.name;
+    std::string extension;
+    switch (m_outputFormat) {
+    case OutputFormat::NDJSON:
+        extension = ".ndjson";
+        break;
+    case OutputFormat::CBOR:
+        extension = ".cbor";
+        break;
+    case OutputFormat::MSGPACK:
+        extension = ".msgpack";
+        break;
+    case OutputFormat::ARROW:
+        // a directory with a file per table
+        extension = ".arrow";
+        break;
+    case OutputFormat::PARQUET:
+        extension = ".parquet";
+        break;
+    default:
+        extension = ".json";
+        break;
+    }
+    if (!isColumnarFormat(m_outputFormat)) {
+        extension += FbUtils::getCompressionExtension(m_compression);
+    }
+    fs::path fileName = m_outputPath / (segmentName + extension);
+    fs::path blobFileName = m_outputPath / (segmentName + ".blobs");
+
+    pImp->writeHeader(m_segmentHeader, fileName, blobFileName);
 } catch (const std::exception& e) {
     IscRandomStatus statusVector(e);
     throw Firebird::FbException(status, statusVector);
@@ -720,10 +1808,7 @@ try {
 
 void SimpleJsonStreamPlugin::finishSegment(ThrowStatusWrapper* status)
 try {
-    std::string segmentName = m_segmentHeader.name;
-    fs::path fileName = m_outputPath / (segmentName + ".json");
-
-    pImp->saveToFile(fileName);
+    pImp->saveToFile();
 } catch (const std::exception& e) {
     IscRandomStatus statusVector(e);
     throw Firebird::FbException(status, statusVector);
@@ -737,9 +1822,17 @@ void SimpleJsonStreamPlugin::setSegmentOffset([[maybe_unused]] ISC_UINT64 offset
 
 IStreamedTransaction* SimpleJsonStreamPlugin::startTransaction(ThrowStatusWrapper* status, ISC_INT64 number)
 try {
-    auto tra = new SimpleJsonPluginTransaction(this, number);
-    m_transactions[number] = tra;
+    SimpleJsonPluginTransaction* tra = nullptr;
+    if (m_transactionPool.empty()) {
+        tra = new SimpleJsonPluginTransaction(this);
+    } else {
+        tra = m_transactionPool.back();
+        m_transactionPool.pop_back();
+    }
+    tra->start(number);
+    m_transactions.insertOrAssign(number, tra);
 
+    const PluginImp::EventRedirect redirect(*pImp, tra->groupedEvents());
     pImp->startTransactionEvent(number);
 
     return tra;
@@ -763,15 +1856,20 @@ try {
 
 FB_BOOLEAN SimpleJsonStreamPlugin::matchTable(ThrowStatusWrapper* status, const char* relationName)
 try {
+    const std::string_view name(relationName);
+    if (const auto it = m_tableMatches.find(name); it != m_tableMatches.end()) {
+        return it->second ? FB_TRUE : FB_FALSE;
+    }
     bool match = true;
     if (m_include_tables != nullptr) {
-        // The table name must match the regular expression
-        match = match && std::regex_match(relationName, *m_include_tables);
+        // The table name must match the filter
+        match = match && m_include_tables->match(name);
     }
     if (m_exclude_tables != nullptr) {
-        // Table name must not match regular expression
-        match = match && !std::regex_match(relationName, *m_exclude_tables);
+        // Table name must not match the filter
+        match = match && !m_exclude_tables->match(name);
     }
+    m_tableMatches.emplace(name, match);
     return match ? FB_TRUE : FB_FALSE;
 } catch (const std::regex_error& e) {
     IscRandomStatus statusVector(e);
@@ -780,13 +1878,12 @@ try {
 
 IStreamedTransaction* SimpleJsonStreamPlugin::getTransaction(ThrowStatusWrapper* status, ISC_INT64 number)
 try {
-    const auto it = m_transactions.find(number);
-    if (it == m_transactions.end()) {
+    const auto tra = m_transactions.find(number);
+    if (tra == nullptr) {
         auto statusVector = IscRandomStatus::createFmtStatus("Transaction %" UQUADFORMAT " not found, segment name %s", number, m_segmentHeader.name);
         throw Firebird::FbException(status, statusVector);
     }
-    auto tra = (*it).second;
-    return tra;
+    return *tra;
 } catch (const std::exception& e) {
     IscRandomStatus statusVector(e);
     throw Firebird::FbException(status, statusVector);
@@ -802,22 +1899,11 @@ try {
 
 void SimpleJsonStreamPlugin::cleanupTransactions(ThrowStatusWrapper* status)
 try {
-    // get a list of transaction numbers
-    std::vector<ISC_INT64> numbers;
-    std::transform(
-        std::begin(m_transactions),
-        std::end(m_transactions),
-        std::back_inserter(numbers),
-        [](auto const& pair) {
-            return pair.first;
-        });
     // rollback all transactions
-    for (auto traNum : numbers) {
-        auto tra = m_transactions[traNum];
+    m_transactions.drain([status](ISC_INT64, IStreamedTransaction* tra) {
         tra->rollback(status);
         tra->dispose();
-        m_transactions.erase(traNum);
-    }
+    });
 } catch (const std::exception& e) {
     IscRandomStatus statusVector(e);
     throw Firebird::FbException(status, statusVector);
@@ -830,37 +1916,212 @@ void SimpleJsonStreamPlugin::log(unsigned level, const char* message)
 
 std::string SimpleJsonStreamPlugin::toUtf8(ThrowStatusWrapper* status, unsigned charsetId, std::string_view s)
 try {
-    auto [it, result] = m_encodingConverters.try_emplace(
-        charsetId,
-        lazy_convert_construct([charsetId, status, this] {
-            return m_stringEncoder.getConverterById(status, charsetId);
-        })
-    );
-    return it->second.toUtf8(status, s);
+    return getConverter(status, charsetId).toUtf8(status, s);
 } catch (const std::exception& e) {
     IscRandomStatus statusVector(e);
     throw FbException(status, statusVector);
 }
 
-SimpleJsonPluginTransaction::SimpleJsonPluginTransaction(SimpleJsonStreamPlugin* applier, ISC_INT64 number)
+const StringConverterHelper::Utf8Conversion* SimpleJsonStreamPlugin::convertTexts(ThrowStatusWrapper* status,
+    const RecordLayout& layout, IStreamedRecord* record)
+{
+    m_textConversions.resize(layout.convertCount);
+    size_t count = 0;
+    for (const auto& fieldLayout : layout.fields) {
+        if (fieldLayout.kind != FieldKind::TEXT_CONVERT && fieldLayout.kind != FieldKind::VARYING_CONVERT) {
+            continue;
+        }
+        const auto fieldData = record->getField(fieldLayout.index)->getData();
+        if (fieldData == nullptr) {
+            continue;
+        }
+        std::string_view s;
+        if (fieldLayout.kind == FieldKind::TEXT_CONVERT) {
+            s = std::string_view(reinterpret_cast<const char*>(fieldData), fieldLayout.length);
+            s = FbUtils::sv_rtrim_char(s, ' ');
+        } else {
+            const auto varchar = reinterpret_cast<const vary*>(fieldData);
+            s = std::string_view(varchar->vary_string, varchar->vary_length);
+        }
+        m_textConversions[count++] = { fieldLayout.converter, s, {} };
+    }
+    StringConverterHelper::toUtf8(status, m_textConversions.data(), count, m_textBuffer);
+    return m_textConversions.data();
+}
+
+void SimpleJsonStreamPlugin::recycleTransaction(SimpleJsonPluginTransaction* transaction) noexcept
+{
+    try {
+        m_transactionPool.push_back(transaction);
+    } catch (const std::bad_alloc&) {
+        delete transaction;
+    }
+    // the transaction no longer keeps the plugin alive
+    release();
+}
+
+StringConverterHelper& SimpleJsonStreamPlugin::getConverter(ThrowStatusWrapper* status, unsigned charsetId)
+{
+    return m_encodingConverters.get(status, charsetId);
+}
+
+const RecordLayout& SimpleJsonStreamPlugin::getRecordLayout(ThrowStatusWrapper* status, const char* relationName, IStreamedRecord* record)
+{
+    std::vector<std::shared_ptr<RecordLayout>>* relationLayouts = nullptr;
+    if (auto it = m_recordLayouts.find(relationName); it != m_recordLayouts.end()) {
+        relationLayouts = &it->second;
+        // The table format may change within the segment. The old format is kept,
+        // an update can have the old record in it and the new one in the current format.
+        for (const auto& layout : *relationLayouts) {
+            if (layout->matches(record)) {
+                return *layout;
+            }
+        }
+    }
+
+    const auto fieldCount = record->getCount();
+    auto layout = std::make_shared<RecordLayout>();
+    layout->relationName = relationName;
+    layout->fieldCount = fieldCount;
+    layout->rawLength = record->getRawLength();
+    layout->convertCount = 0;
+    layout->fields.reserve(fieldCount);
+    layout->signature.reserve(fieldCount);
+    for (unsigned i = 0; i < fieldCount; i++) {
+        auto field = record->getField(i);
+        layout->signature.push_back(getFieldSignature(field));
+        // For calculated fields, it may return null.
+        if (!field)
+            continue;
+
+        FieldLayout fieldLayout {};
+        fieldLayout.index = i;
+        fieldLayout.scale = static_cast<short>(field->getScale());
+        fieldLayout.length = field->getLength();
+        fieldLayout.name = field->getName();
+        fieldLayout.key.push_back('"');
+        FbUtils::JsonWriter::escape(fieldLayout.key, fieldLayout.name);
+        fieldLayout.key.append("\":", 2);
+        fieldLayout.converter = nullptr;
+
+        const auto charsetId = field->getCharSet();
+        const bool needConvert = (charsetId != CS_UTF8) && (charsetId != CS_NONE);
+        switch (field->getType()) {
+        case SQL_TEXT:
+            if (charsetId == CS_BINARY)
+                fieldLayout.kind = FieldKind::TEXT_BINARY;
+            else
+                fieldLayout.kind = needConvert ? FieldKind::TEXT_CONVERT : FieldKind::TEXT;
+            break;
+        case SQL_VARYING:
+            if (charsetId == CS_BINARY)
+                fieldLayout.kind = FieldKind::VARYING_BINARY;
+            else
+                fieldLayout.kind = needConvert ? FieldKind::VARYING_CONVERT : FieldKind::VARYING;
+            break;
+        case SQL_SHORT:
+            fieldLayout.kind = (fieldLayout.scale == 0) ? FieldKind::SHORT : FieldKind::SHORT_SCALED;
+            break;
+        case SQL_LONG:
+            fieldLayout.kind = (fieldLayout.scale == 0) ? FieldKind::LONG : FieldKind::LONG_SCALED;
+            break;
+        case SQL_INT64:
+            fieldLayout.kind = (fieldLayout.scale == 0) ? FieldKind::INT64 : FieldKind::INT64_SCALED;
+            break;
+        case SQL_INT128:
+            fieldLayout.kind = FieldKind::INT128;
+            break;
+        case SQL_FLOAT:
+            fieldLayout.kind = FieldKind::FLOAT;
+            break;
+        case SQL_DOUBLE:
+            [[fallthrough]];
+        case SQL_D_FLOAT:
+            fieldLayout.kind = FieldKind::DOUBLE;
+            break;
+        case SQL_TIMESTAMP:
+            fieldLayout.kind = FieldKind::TIMESTAMP;
+            break;
+        case SQL_TYPE_DATE:
+            fieldLayout.kind = FieldKind::DATE;
+            break;
+        case SQL_TYPE_TIME:
+            fieldLayout.kind = FieldKind::TIME;
+            break;
+        case SQL_TIMESTAMP_TZ:
+            fieldLayout.kind = FieldKind::TIMESTAMP_TZ;
+            break;
+        case SQL_TIME_TZ:
+            fieldLayout.kind = FieldKind::TIME_TZ;
+            break;
+        case SQL_BOOLEAN:
+            fieldLayout.kind = FieldKind::BOOLEAN;
+            break;
+        case SQL_DEC16:
+            fieldLayout.kind = FieldKind::DEC16;
+            break;
+        case SQL_DEC34:
+            fieldLayout.kind = FieldKind::DEC34;
+            break;
+        case SQL_BLOB:
+            fieldLayout.kind = FieldKind::BLOB;
+            break;
+        case SQL_ARRAY:
+            // an error is raised only if the field has a value
+            fieldLayout.kind = FieldKind::ARRAY;
+            break;
+        default:
+            fieldLayout.kind = FieldKind::UNKNOWN;
+            break;
+        }
+        if (fieldLayout.kind == FieldKind::TEXT_CONVERT || fieldLayout.kind == FieldKind::VARYING_CONVERT) {
+            fieldLayout.converter = &getConverter(status, charsetId);
+            layout->convertCount++;
+        }
+        layout->fields.push_back(std::move(fieldLayout));
+    }
+
+    const auto& result = *layout;
+    if (relationLayouts) {
+        relationLayouts->push_back(std::move(layout));
+    } else {
+        m_recordLayouts[result.relationName].push_back(std::move(layout));
+    }
+    return result;
+}
+
+SimpleJsonPluginTransaction::SimpleJsonPluginTransaction(SimpleJsonStreamPlugin* applier)
     : m_streamPlugin(applier)
-    , m_number(number)
+    , m_number(0)
 {
-    m_streamPlugin->addRef(); // Lock parent from disappearing
 }
 
 SimpleJsonPluginTransaction::~SimpleJsonPluginTransaction()
 {
-    m_streamPlugin->release();
+}
+
+void SimpleJsonPluginTransaction::start(ISC_INT64 number)
+{
+    m_number = number;
+    m_events.clear();
+    m_layouts.clear();
+    m_streamPlugin->addRef(); // Lock parent from disappearing
 }
 
 void SimpleJsonPluginTransaction::dispose()
 {
-    delete this;
+    // may destroy the plugin together with this object, so it is the last thing done
+    m_streamPlugin->recycleTransaction(this);
+}
+
+FbUtils::EventBuffer* SimpleJsonPluginTransaction::groupedEvents()
+{
+    return m_streamPlugin->m_transactionGrouping ? &m_events : nullptr;
 }
 
 void SimpleJsonPluginTransaction::prepare(ThrowStatusWrapper* status)
 try {
+    const SimpleJsonStreamPlugin::PluginImp::EventRedirect redirect(*m_streamPlugin->pImp, groupedEvents());
     m_streamPlugin->pImp->prepareTransactionEvent(m_number);
 } catch (const std::exception& e) {
     IscRandomStatus statusVector(e);
@@ -869,6 +2130,11 @@ try {
 
 void SimpleJsonPluginTransaction::commit(ThrowStatusWrapper* status)
 try {
+    if (m_streamPlugin->m_transactionGrouping) {
+        m_streamPlugin->pImp->writeBufferedEvents(status, m_streamPlugin->getNumericFormatter(), m_events);
+        m_events.clear();
+        m_layouts.clear();
+    }
     m_streamPlugin->pImp->commitEvent(m_number);
 } catch (const std::exception& e) {
     IscRandomStatus statusVector(e);
@@ -877,6 +2143,12 @@ try {
 
 void SimpleJsonPluginTransaction::rollback(ThrowStatusWrapper* status)
 try {
+    if (m_streamPlugin->m_transactionGrouping) {
+        // nothing of the transaction is written
+        m_events.clear();
+        m_layouts.clear();
+        return;
+    }
     m_streamPlugin->pImp->rollbackEvent(m_number);
 } catch (const std::exception& e) {
     IscRandomStatus statusVector(e);
@@ -885,6 +2157,11 @@ try {
 
 void SimpleJsonPluginTransaction::startSavepoint(ThrowStatusWrapper* status)
 try {
+    if (m_streamPlugin->m_transactionGrouping) {
+        // savepoints are resolved in the buffer, the output has no savepoint events
+        m_events.startSavepoint();
+        return;
+    }
     m_streamPlugin->pImp->savepointEvent(m_number);
 } catch (const std::exception& e) {
     IscRandomStatus statusVector(e);
@@ -893,6 +2170,10 @@ try {
 
 void SimpleJsonPluginTransaction::releaseSavepoint(ThrowStatusWrapper* status)
 try {
+    if (m_streamPlugin->m_transactionGrouping) {
+        m_events.releaseSavepoint();
+        return;
+    }
     m_streamPlugin->pImp->releaseSavepointEvent(m_number);
 } catch (const std::exception& e) {
     IscRandomStatus statusVector(e);
@@ -901,6 +2182,10 @@ try {
 
 void SimpleJsonPluginTransaction::rollbackSavepoint(ThrowStatusWrapper* status)
 try {
+    if (m_streamPlugin->m_transactionGrouping) {
+        m_events.rollbackSavepoint();
+        return;
+    }
     m_streamPlugin->pImp->rollbackSavepointEvent(m_number);
 } catch (const std::exception& e) {
     IscRandomStatus statusVector(e);
@@ -916,10 +2201,27 @@ try {
         return;
     }
     m_streamPlugin->m_logger->debug(FbUtils::vformat("[%" UQUADFORMAT "] INSERT %s (length: %d)", m_number, name, record->getRawLength()).c_str());
+    const SimpleJsonStreamPlugin::PluginImp::EventRedirect redirect(*m_streamPlugin->pImp, groupedEvents());
+
+    if (m_streamPlugin->pImp->isColumnar()) {
+        appendColumnarRecord(status, RowOperation::INSERTED, name, record);
+        return;
+    }
+
+    if (m_streamPlugin->pImp->isDirectSerializer()) {
+        auto& recordWriter = m_streamPlugin->pImp->getNewRecordWriter();
+        recordWriter.start();
+        dumpRecord(status, m_streamPlugin, m_streamPlugin->getRecordLayout(status, name, record), record, recordWriter);
+        recordWriter.finish();
+
+        m_streamPlugin->pImp->insertRecordEvent(m_number, name, recordWriter);
+        return;
+    }
 
     ordered_json jRecord;
+    JsonRecordBuilder recordBuilder(jRecord, m_streamPlugin->pImp->getBinaryEncoding());
 
-    dumpRecord(status, m_streamPlugin, record, jRecord);
+    dumpRecord(status, m_streamPlugin, m_streamPlugin->getRecordLayout(status, name, record), record, recordBuilder);
 
     m_streamPlugin->pImp->insertRecordEvent(m_number, name, jRecord);
 
@@ -943,12 +2245,36 @@ try {
         return;
     }
     m_streamPlugin->m_logger->debug(FbUtils::vformat("[%" UQUADFORMAT "] UPDATE %s (orgLength: %d, newLength: %d)", m_number, name, orgRecord->getRawLength(), newRecord->getRawLength()).c_str());
+    const SimpleJsonStreamPlugin::PluginImp::EventRedirect redirect(*m_streamPlugin->pImp, groupedEvents());
+
+    if (m_streamPlugin->pImp->isColumnar()) {
+        appendColumnarRecord(status, RowOperation::UPDATED_OLD, name, orgRecord);
+        appendColumnarRecord(status, RowOperation::UPDATED_NEW, name, newRecord);
+        return;
+    }
+
+    if (m_streamPlugin->pImp->isDirectSerializer()) {
+        auto& orgRecordWriter = m_streamPlugin->pImp->getOrgRecordWriter();
+        orgRecordWriter.start();
+        dumpRecord(status, m_streamPlugin, m_streamPlugin->getRecordLayout(status, name, orgRecord), orgRecord, orgRecordWriter);
+        orgRecordWriter.finish();
+
+        auto& newRecordWriter = m_streamPlugin->pImp->getNewRecordWriter();
+        newRecordWriter.start();
+        dumpRecord(status, m_streamPlugin, m_streamPlugin->getRecordLayout(status, name, newRecord), newRecord, newRecordWriter);
+        newRecordWriter.finish();
+
+        m_streamPlugin->pImp->updateRecordEvent(m_number, name, orgRecordWriter, newRecordWriter);
+        return;
+    }
 
     ordered_json jOrgRecord;
     ordered_json jNewRecord;
+    JsonRecordBuilder orgRecordBuilder(jOrgRecord, m_streamPlugin->pImp->getBinaryEncoding());
+    JsonRecordBuilder newRecordBuilder(jNewRecord, m_streamPlugin->pImp->getBinaryEncoding());
 
-    dumpRecord(status, m_streamPlugin, orgRecord, jOrgRecord);
-    dumpRecord(status, m_streamPlugin, newRecord, jNewRecord);
+    dumpRecord(status, m_streamPlugin, m_streamPlugin->getRecordLayout(status, name, orgRecord), orgRecord, orgRecordBuilder);
+    dumpRecord(status, m_streamPlugin, m_streamPlugin->getRecordLayout(status, name, newRecord), newRecord, newRecordBuilder);
 
     m_streamPlugin->pImp->updateRecordEvent(m_number, name, jOrgRecord, jNewRecord);
 } catch (const std::exception& e) {
@@ -965,10 +2291,27 @@ try {
         return;
     }
     m_streamPlugin->m_logger->debug(FbUtils::vformat("[%" UQUADFORMAT "] DELETE %s (length: %d)", m_number, name, record->getRawLength()).c_str());
+    const SimpleJsonStreamPlugin::PluginImp::EventRedirect redirect(*m_streamPlugin->pImp, groupedEvents());
+
+    if (m_streamPlugin->pImp->isColumnar()) {
+        appendColumnarRecord(status, RowOperation::DELETED, name, record);
+        return;
+    }
+
+    if (m_streamPlugin->pImp->isDirectSerializer()) {
+        auto& recordWriter = m_streamPlugin->pImp->getOrgRecordWriter();
+        recordWriter.start();
+        dumpRecord(status, m_streamPlugin, m_streamPlugin->getRecordLayout(status, name, record), record, recordWriter);
+        recordWriter.finish();
+
+        m_streamPlugin->pImp->deleteRecordEvent(m_number, name, recordWriter);
+        return;
+    }
 
     ordered_json jRecord;
+    JsonRecordBuilder recordBuilder(jRecord, m_streamPlugin->pImp->getBinaryEncoding());
 
-    dumpRecord(status, m_streamPlugin, record, jRecord);
+    dumpRecord(status, m_streamPlugin, m_streamPlugin->getRecordLayout(status, name, record), record, recordBuilder);
 
     m_streamPlugin->pImp->deleteRecordEvent(m_number, name, jRecord);
 } catch (const std::exception& e) {
@@ -976,13 +2319,29 @@ try {
     throw Firebird::FbException(status, statusVector);
 }
 
+void SimpleJsonPluginTransaction::appendColumnarRecord(ThrowStatusWrapper* status, RowOperation operation, const char* name, IStreamedRecord* record)
+{
+    const auto& layout = m_streamPlugin->getRecordLayout(status, name, record);
+    const auto kept = std::find_if(m_layouts.begin(), m_layouts.end(), [&layout](const auto& keptLayout) {
+        return keptLayout.get() == &layout;
+    });
+    if (kept == m_layouts.end()) {
+        m_layouts.push_back(layout.shared_from_this());
+    }
+    m_streamPlugin->pImp->appendColumnarRecord(operation, m_number, layout, record);
+}
+
 void SimpleJsonPluginTransaction::executeSql(ThrowStatusWrapper* status, const char* sql)
 try {
+    // DDL may change table formats
+    m_streamPlugin->m_recordLayouts.clear();
+
     if (!m_streamPlugin->m_registerDDL) {
         // If registration of DDL events is disabled, exit.
         return;
     }
 
+    const SimpleJsonStreamPlugin::PluginImp::EventRedirect redirect(*m_streamPlugin->pImp, groupedEvents());
     m_streamPlugin->pImp->executeSqlEvent(m_number, sql);
 
 } catch (const std::exception& e) {
@@ -992,6 +2351,9 @@ try {
 
 void SimpleJsonPluginTransaction::executeSqlIntl(ThrowStatusWrapper* status, unsigned charset, const char* sql)
 {
+    // DDL may change table formats
+    m_streamPlugin->m_recordLayouts.clear();
+
     if (!m_streamPlugin->m_registerDDL) {
         // If registration of DDL events is disabled, exit.
         return;
@@ -1004,11 +2366,13 @@ void SimpleJsonPluginTransaction::executeSqlIntl(ThrowStatusWrapper* status, uns
 void SimpleJsonPluginTransaction::storeBlob(ThrowStatusWrapper* status, ISC_QUAD* blob_id,
     ISC_INT64 length, const unsigned char* data)
 try {
-    if (!m_streamPlugin->m_dumpBlobs) {
+    if (!m_streamPlugin->m_dumpBlobs || m_streamPlugin->pImp->isColumnar()) {
         // If the BLOB dump is disabled, then exit. This will save memory consumption.
+        // Columnar output has no blob events, they would wait for the commit for nothing.
         return;
     }
 
+    const SimpleJsonStreamPlugin::PluginImp::EventRedirect redirect(*m_streamPlugin->pImp, groupedEvents());
     m_streamPlugin->pImp->storeBlobEvent(m_number, blob_id, length, data);
 } catch (const std::exception& e) {
     IscRandomStatus statusVector(e);
@@ -0,0 +1,98 @@
+#include <chrono>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+
+#include "../../common/AsyncFileWriter.h"
+#include "TestChecks.h"
+#include "Tests.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+using FbUtils::AsyncFileWriter;
+
+std::string readFile(const fs::path& fileName)
+{
+    std::ifstream file(fileName, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+// The same text for the writer and the check.
+std::string makeLine(unsigned n)
+{
+    return "line " + std::to_string(n) + " of the async writer test\n";
+}
+
+} // namespace
+
+namespace SimpleJsonTests {
+
+void testAsyncFileWriter()
+{
+    const auto directory = fs::temp_directory_path() / "simple_json_tests_async_writer";
+    fs::remove_all(directory);
+    fs::create_directories(directory);
+
+    {
+        // a short queue of small chunks, so that both threads wait for each other many times
+        AsyncFileWriter writer(2, 64);
+        for (unsigned file = 0; file < 3; file++) {
+            const auto tempName = directory / ("file" + std::to_string(file) + ".tmp");
+            const auto fileName = directory / ("file" + std::to_string(file) + ".txt");
+            writer.open(tempName);
+            std::string expected;
+            for (unsigned n = 0; n < 20000; n++) {
+                const auto line = makeLine(n);
+                writer.write(line.data(), line.size());
+                expected += line;
+            }
+            writer.closeAndRename(fileName);
+            writer.wait();
+            CHECK(!fs::exists(tempName));
+            CHECK(readFile(fileName) == expected);
+        }
+
+        // the writer thread waits for work while nothing is submitted
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        const auto fileName = directory / "idle.txt";
+        writer.open(fileName);
+        writer.write("after idle", 10);
+        writer.close();
+        writer.wait();
+        CHECK_EQUAL(readFile(fileName), std::string("after idle"));
+
+        // a failed rename is raised by wait() of the same file, not by the open of the next one
+        const auto tempName = directory / "failed.tmp";
+        writer.open(tempName);
+        writer.write("failed rename", 13);
+        writer.closeAndRename(directory / "missing" / "failed.txt");
+        bool failed = false;
+        try {
+            writer.wait();
+        } catch (const std::exception&) {
+            failed = true;
+        }
+        CHECK(failed);
+        CHECK_EQUAL(readFile(tempName), std::string("failed rename"));
+        const auto nextName = directory / "next.txt";
+        writer.open(nextName);
+        writer.write("next", 4);
+        writer.close();
+        writer.wait();
+        CHECK_EQUAL(readFile(nextName), std::string("next"));
+
+        // the file of the last open is left to the destructor, which must not hang
+        writer.open(directory / "abandoned.txt");
+        writer.write("abandoned", 9);
+        writer.flush();
+    }
+
+    fs::remove_all(directory);
+}
+
+} // namespace SimpleJsonTests
@@ -0,0 +1,153 @@
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../../common/BinaryEncoding.h"
+#include "TestChecks.h"
+#include "Tests.h"
+
+namespace {
+
+using FbUtils::SimdLevel;
+
+// written after the encoded text, an encoder must leave it alone
+constexpr char GUARD = '#';
+constexpr size_t GUARD_SIZE = 64;
+
+// The processor's levels, the scalar one first.
+std::vector<SimdLevel> getSupportedLevels()
+{
+    std::vector<SimdLevel> levels;
+    for (const auto level : { SimdLevel::SCALAR, SimdLevel::SSE2, SimdLevel::AVX2 }) {
+        if (level <= FbUtils::getSimdLevel()) {
+            levels.push_back(level);
+        }
+    }
+    return levels;
+}
+
+std::vector<unsigned char> makeData(std::mt19937_64& random, size_t size)
+{
+    std::vector<unsigned char> data(size);
+    for (auto& byte : data) {
+        byte = static_cast<unsigned char>(random());
+    }
+    return data;
+}
+
+// Runs encoder at the level and checks that it writes exactly encodedSize characters.
+template <typename Encoder>
+std::string encodeAt(Encoder encoder, const unsigned char* data, size_t size, size_t encodedSize, SimdLevel level)
+{
+    std::string output(encodedSize + GUARD_SIZE, GUARD);
+    const auto end = encoder(data, size, output.data(), level);
+    CHECK_EQUAL(static_cast<size_t>(end - output.data()), encodedSize);
+    CHECK_EQUAL(output.substr(encodedSize), std::string(GUARD_SIZE, GUARD));
+    output.resize(encodedSize);
+    return output;
+}
+
+std::string encodeHexAt(const unsigned char* data, size_t size, SimdLevel level)
+{
+    return encodeAt(
+        [](const unsigned char* input, size_t inputSize, char* out, SimdLevel encoderLevel) {
+            return FbUtils::encodeHex(input, inputSize, out, encoderLevel);
+        },
+        data, size, FbUtils::hexEncodedSize(size), level);
+}
+
+std::string encodeBase64At(const unsigned char* data, size_t size, SimdLevel level)
+{
+    return encodeAt(
+        [](const unsigned char* input, size_t inputSize, char* out, SimdLevel encoderLevel) {
+            return FbUtils::encodeBase64(input, inputSize, out, encoderLevel);
+        },
+        data, size, FbUtils::base64EncodedSize(size), level);
+}
+
+std::string referenceHex(const std::vector<unsigned char>& data)
+{
+    static const char digits[] = "0123456789ABCDEF";
+    std::string text;
+    for (const auto byte : data) {
+        text.push_back(digits[byte >> 4]);
+        text.push_back(digits[byte & 15]);
+    }
+    return text;
+}
+
+} // namespace
+
+namespace SimpleJsonTests {
+
+void testHexEncoding()
+{
+    std::vector<unsigned char> allBytes;
+    for (unsigned i = 0; i < 256; i++) {
+        allBytes.push_back(static_cast<unsigned char>(i));
+    }
+    for (const auto level : getSupportedLevels()) {
+        CHECK_EQUAL(encodeHexAt(allBytes.data(), allBytes.size(), level), referenceHex(allBytes));
+    }
+
+    // every length crosses the vector loops and their scalar tails, the offset misaligns the input
+    std::mt19937_64 random(20261017);
+    for (size_t size = 0; size <= 600; size++) {
+        const auto offset = size % 32;
+        const auto data = makeData(random, offset + size);
+        const auto input = data.data() + offset;
+        const auto expected = encodeHexAt(input, size, SimdLevel::SCALAR);
+        CHECK_EQUAL(expected, referenceHex({ input, input + size }));
+        for (const auto level : getSupportedLevels()) {
+            CHECK_EQUAL(encodeHexAt(input, size, level), expected);
+        }
+    }
+}
+
+void testBase64Encoding()
+{
+    // RFC 4648, section 10
+    const char* const vectors[][2] = {
+        { "", "" },
+        { "f", "Zg==" },
+        { "fo", "Zm8=" },
+        { "foo", "Zm9v" },
+        { "foob", "Zm9vYg==" },
+        { "fooba", "Zm9vYmE=" },
+        { "foobar", "Zm9vYmFy" }
+    };
+    for (const auto& [text, encoded] : vectors) {
+        const std::string input(text);
+        for (const auto level : getSupportedLevels()) {
+            CHECK_EQUAL(encodeBase64At(reinterpret_cast<const unsigned char*>(input.data()), input.size(), level),
+                std::string(encoded));
+        }
+    }
+
+    // the characters '+' and '/' and every value of the 6-bit groups
+    const unsigned char allValues[] = {
+        0x00, 0x10, 0x83, 0x10, 0x51, 0x87, 0x20, 0x92, 0x8B, 0x30, 0xD3, 0x8F,
+        0x41, 0x14, 0x93, 0x51, 0x55, 0x97, 0x61, 0x96, 0x9B, 0x71, 0xD7, 0x9F,
+        0x82, 0x18, 0xA3, 0x92, 0x59, 0xA7, 0xA2, 0x9A, 0xAB, 0xB2, 0xDB, 0xAF,
+        0xC3, 0x1C, 0xB3, 0xD3, 0x5D, 0xB7, 0xE3, 0x9E, 0xBB, 0xF3, 0xDF, 0xBF
+    };
+    const std::string alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    for (const auto level : getSupportedLevels()) {
+        CHECK_EQUAL(encodeBase64At(allValues, sizeof(allValues), level), alphabet);
+    }
+
+    // the AVX2 loop reads 28 bytes per 24 encoded, random lengths land on both sides of its end
+    std::mt19937_64 random(20261017);
+    for (int i = 0; i < 5000; i++) {
+        const size_t size = (i <= 600) ? i : random() % 4096;
+        const auto offset = random() % 32;
+        const auto data = makeData(random, offset + size);
+        const auto input = data.data() + offset;
+        const auto expected = encodeBase64At(input, size, SimdLevel::SCALAR);
+        for (const auto level : getSupportedLevels()) {
+            CHECK_EQUAL(encodeBase64At(input, size, level), expected);
+        }
+    }
+}
+
+} // namespace SimpleJsonTests
@@ -0,0 +1,118 @@
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+
+#include "../../common/DateTimeFormatter.h"
+#include "TestChecks.h"
+#include "Tests.h"
+
+namespace {
+
+using FbUtils::DateTimeFormatter;
+
+// Days since 1970-01-01 of a proleptic Gregorian date, H. Hinnant's days_from_civil,
+// an algorithm independent of the one DateTimeFormatter takes from Firebird.
+int64_t daysFromCivil(int64_t year, unsigned month, unsigned day)
+{
+    year -= (month <= 2) ? 1 : 0;
+    const int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const auto yearOfEra = static_cast<unsigned>(year - era * 400);
+    const unsigned dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + static_cast<int64_t>(dayOfEra) - 719468;
+}
+
+unsigned daysInMonth(unsigned year, unsigned month)
+{
+    static const unsigned days[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    const bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    return (month == 2 && leap) ? 29 : days[month - 1];
+}
+
+std::string referenceTime(unsigned hours, unsigned minutes, unsigned seconds, unsigned fractions)
+{
+    char text[32];
+    snprintf(text, sizeof(text), "%02u:%02u:%02u.%04u", hours, minutes, seconds, fractions);
+    return text;
+}
+
+std::string formatTime(ISC_TIME time)
+{
+    char text[DateTimeFormatter::TIME_SIZE];
+    const auto end = DateTimeFormatter::formatTime(time, text);
+    CHECK_EQUAL(static_cast<size_t>(end - text), size_t { DateTimeFormatter::TIME_SIZE });
+    return std::string(text, end);
+}
+
+} // namespace
+
+namespace SimpleJsonTests {
+
+void testDateTimeFormatter()
+{
+    // every day of 0001-01-01..9999-12-31, the cache sees each date once and then again
+    DateTimeFormatter formatter;
+    const auto epoch = daysFromCivil(1858, 11, 17);
+    for (unsigned year = 1; year <= 9999; year++) {
+        for (unsigned month = 1; month <= 12; month++) {
+            for (unsigned day = 1; day <= daysInMonth(year, month); day++) {
+                const auto date = static_cast<ISC_DATE>(daysFromCivil(year, month, day) - epoch);
+                unsigned decodedYear = 0, decodedMonth = 0, decodedDay = 0;
+                DateTimeFormatter::decodeDate(date, decodedYear, decodedMonth, decodedDay);
+                if (decodedYear != year || decodedMonth != month || decodedDay != day) {
+                    CHECK_EQUAL(decodedYear, year);
+                    CHECK_EQUAL(decodedMonth, month);
+                    CHECK_EQUAL(decodedDay, day);
+                    continue;
+                }
+
+                char expected[16];
+                snprintf(expected, sizeof(expected), "%04u-%02u-%02u", year, month, day);
+                char text[DateTimeFormatter::DATE_SIZE];
+                for (int pass = 0; pass < 2; pass++) {
+                    const auto end = formatter.formatDate(date, text);
+                    CHECK_EQUAL(std::string(text, end), std::string(expected));
+                }
+            }
+        }
+    }
+
+    // every second of the day with a fraction that needs the zero padding
+    for (unsigned seconds = 0; seconds < 24 * 3600; seconds++) {
+        const unsigned fractions = (seconds * 7) % 10000;
+        const auto time = static_cast<ISC_TIME>(seconds * 10000 + fractions);
+        CHECK_EQUAL(formatTime(time), referenceTime(seconds / 3600, seconds / 60 % 60, seconds % 60, fractions));
+    }
+    CHECK_EQUAL(formatTime(5), std::string("00:00:00.0005"));
+    CHECK_EQUAL(formatTime(5000), std::string("00:00:00.5000"));
+    CHECK_EQUAL(formatTime(863999999), std::string("23:59:59.9999"));
+
+    std::mt19937_64 random(20261017);
+    for (int i = 0; i < 100000; i++) {
+        const ISC_TIMESTAMP timestamp {
+            static_cast<ISC_DATE>(random() % 3652059) - 678575,
+            static_cast<ISC_TIME>(random() % 864000000)
+        };
+        unsigned year = 0, month = 0, day = 0;
+        DateTimeFormatter::decodeDate(timestamp.timestamp_date, year, month, day);
+        unsigned hours = 0, minutes = 0, seconds = 0, fractions = 0;
+        DateTimeFormatter::decodeTime(timestamp.timestamp_time, hours, minutes, seconds, fractions);
+        char expected[32];
+        snprintf(expected, sizeof(expected), "%04u-%02u-%02u %s", year, month, day,
+            referenceTime(hours, minutes, seconds, fractions).c_str());
+
+        char text[DateTimeFormatter::TIMESTAMP_SIZE];
+        const auto end = formatter.formatTimestamp(timestamp, text);
+        CHECK_EQUAL(std::string(text, end), std::string(expected));
+    }
+
+    // the epoch and the bounds of the range with a cleared cache
+    formatter.resetCache();
+    char text[DateTimeFormatter::DATE_SIZE];
+    CHECK_EQUAL(std::string(text, formatter.formatDate(0, text)), std::string("1858-11-17"));
+    CHECK_EQUAL(std::string(text, formatter.formatDate(-678575, text)), std::string("0001-01-01"));
+    CHECK_EQUAL(std::string(text, formatter.formatDate(2973483, text)), std::string("9999-12-31"));
+}
+
+} // namespace SimpleJsonTests
@@ -0,0 +1,91 @@
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+#include "../../common/JsonWriter.h"
+#include "TestChecks.h"
+#include "Tests.h"
+
+namespace {
+
+using FbUtils::JsonWriter;
+
+// The text nlohmann::json writes for the value, JsonWriter must match it byte for byte.
+template <typename T>
+std::string referenceJson(const T& value)
+{
+    return nlohmann::ordered_json(value).dump();
+}
+
+void checkDouble(double value)
+{
+    JsonWriter writer;
+    writer.doubleValue(value);
+    CHECK_EQUAL(writer.view(), referenceJson(value));
+}
+
+void checkString(const std::string& value)
+{
+    JsonWriter writer;
+    writer.stringValue(value);
+    CHECK_EQUAL(writer.view(), referenceJson(value));
+}
+
+} // namespace
+
+namespace SimpleJsonTests {
+
+void testJsonWriter()
+{
+    using limits = std::numeric_limits<double>;
+
+    const double doubles[] = {
+        0.0, -0.0, 0.1, -0.1, 0.3, 1.0, -1.0, 1.5, 100.0, 123456789.0,
+        1e15, 1e16, 1e17, 1e21, 1e22, -1e21, 1e-5, 1e-6, 1e-7, 1.7976931348623157e308,
+        limits::max(), limits::lowest(), limits::min(), limits::denorm_min(), -limits::denorm_min(),
+        2.2250738585072009e-308, 4.9406564584124654e-324, limits::epsilon(),
+        static_cast<double>(std::numeric_limits<float>::max()), static_cast<double>(3.14159f),
+        limits::infinity(), -limits::infinity(), limits::quiet_NaN()
+    };
+    for (const auto value : doubles) {
+        checkDouble(value);
+    }
+
+    // random bit patterns cover every exponent, FLOAT columns arrive as float
+    std::mt19937_64 random(20261017);
+    for (int i = 0; i < 100000; i++) {
+        const uint64_t bits = random();
+        double value;
+        memcpy(&value, &bits, sizeof(value));
+        checkDouble(value);
+
+        const auto floatBits = static_cast<uint32_t>(random());
+        float floatValue;
+        memcpy(&floatValue, &floatBits, sizeof(floatValue));
+        checkDouble(static_cast<double>(floatValue));
+    }
+
+    checkString("");
+    checkString("plain text");
+    checkString("quote \" backslash \\ slash /");
+    checkString(std::string("\x00\x01\x08\t\n\x0c\r\x1f\x7f", 9));
+    checkString("\xd0\x9f\xd1\x80\xd0\xb8\xd0\xb2\xd0\xb5\xd1\x82 \xe2\x82\xac \xf0\x9f\x98\x80");
+
+    JsonWriter writer;
+    writer.startArray();
+    writer.intValue(std::numeric_limits<int64_t>::min());
+    writer.intValue(std::numeric_limits<int64_t>::max());
+    writer.uintValue(std::numeric_limits<uint64_t>::max());
+    writer.boolValue(true);
+    writer.nullValue();
+    writer.endArray();
+    const nlohmann::ordered_json array = { std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max(),
+        std::numeric_limits<uint64_t>::max(), true, nullptr };
+    CHECK_EQUAL(writer.view(), array.dump());
+}
+
+} // namespace SimpleJsonTests
@@ -0,0 +1,260 @@
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+#include <string_view>
+
+#include "../../common/NumericFormatter.h"
+#include "TestChecks.h"
+#include "Tests.h"
+
+namespace {
+
+using FbUtils::NumericFormatter;
+
+struct ScaledCase {
+    int64_t value;
+    int scale;
+    const char* expected;
+};
+
+constexpr int64_t INT64_MIN_VALUE = std::numeric_limits<int64_t>::min();
+
+// SMALLINT values, including -0.x fractions that were once written as "-0.-x"
+const ScaledCase smallintCases[] = {
+    { 0, 0, "0" },
+    { 0, -2, "0.00" },
+    { 1, -1, "0.1" },
+    { -1, -1, "-0.1" },
+    { 5, -1, "0.5" },
+    { -5, -1, "-0.5" },
+    { -45, -2, "-0.45" },
+    { -12345, -5, "-0.12345" },
+    { 123, -2, "1.23" },
+    { -123, -2, "-1.23" },
+    { 12345, -2, "123.45" },
+    { -12345, -2, "-123.45" },
+    { 32767, 0, "32767" },
+    { 32767, -4, "3.2767" },
+    { -32768, 0, "-32768" },
+    { -32768, -4, "-3.2768" },
+    { -32768, -5, "-0.32768" },
+    { 32767, -18, "0.000000000000032767" },
+    { -32768, -18, "-0.000000000000032768" }
+};
+
+const ScaledCase integerCases[] = {
+    { 2147483647, 0, "2147483647" },
+    { -2147483648LL, 0, "-2147483648" },
+    { 2147483647, -1, "214748364.7" },
+    { -2147483648LL, -1, "-214748364.8" },
+    { 2147483647, -9, "2.147483647" },
+    { -2147483648LL, -9, "-2.147483648" },
+    { 2147483647, -10, "0.2147483647" },
+    { -2147483648LL, -10, "-0.2147483648" },
+    { -7, -9, "-0.000000007" },
+    { 2147483647, -18, "0.000000002147483647" },
+    { -2147483648LL, -18, "-0.000000002147483648" }
+};
+
+// BIGINT values, including those that do not fit 32 bits
+const ScaledCase bigintCases[] = {
+    { 9223372036854775807LL, 0, "9223372036854775807" },
+    { INT64_MIN_VALUE, 0, "-9223372036854775808" },
+    { 9223372036854775807LL, -1, "922337203685477580.7" },
+    { INT64_MIN_VALUE, -1, "-922337203685477580.8" },
+    { 9223372036854775807LL, -18, "9.223372036854775807" },
+    { INT64_MIN_VALUE, -18, "-9.223372036854775808" },
+    { 9223372036854775807LL, -19, "0.9223372036854775807" },
+    { INT64_MIN_VALUE, -19, "-0.9223372036854775808" },
+    { 12345678901LL, -2, "123456789.01" },
+    { -12345678901LL, -2, "-123456789.01" },
+    { -1, -18, "-0.000000000000000001" },
+    { 1, -18, "0.000000000000000001" },
+    { 0, -18, "0.000000000000000000" }
+};
+
+// positive scales add zeros, scales out of -38..4 are written with an exponent
+const ScaledCase otherScaleCases[] = {
+    { 12, 2, "1200" },
+    { -12, 4, "-120000" },
+    { 12, 5, "12E5" },
+    { -12, -39, "-12E-39" },
+    { 0, 5, "0E5" }
+};
+
+template <size_t N>
+void checkCases(const ScaledCase (&cases)[N])
+{
+    for (const auto& c : cases) {
+        char buffer[NumericFormatter::SCALED_INTEGER_STRING_SIZE];
+        const auto text = NumericFormatter::formatScaledInteger(c.value, c.scale, buffer);
+        CHECK_EQUAL(text, std::string_view(c.expected));
+    }
+}
+
+// The decimal digits with the point inserted by string operations, for scales from 0 to -18.
+std::string referenceScaled(int64_t value, int scale)
+{
+    std::string digits = std::to_string(value);
+    const bool negative = digits[0] == '-';
+    if (negative) {
+        digits.erase(0, 1);
+    }
+    const auto fraction = static_cast<size_t>(-scale);
+    if (digits.size() <= fraction) {
+        digits = std::string(fraction - digits.size() + 1, '0') + digits;
+    }
+    std::string result(negative ? "-" : "");
+    result += digits.substr(0, digits.size() - fraction);
+    if (fraction > 0) {
+        result += '.';
+        result += digits.substr(digits.size() - fraction);
+    }
+    return result;
+}
+
+// Formats the values as the plugin does for a field of type T, at every scale from 0 to -18.
+template <typename T>
+void checkAllScales()
+{
+    constexpr T MIN = std::numeric_limits<T>::min();
+    constexpr T MAX = std::numeric_limits<T>::max();
+    const T values[] = { 0, 1, -1, 9, -9, 10, -10, 99, -99, MIN, MAX, static_cast<T>(MIN + 1), static_cast<T>(MAX - 1), static_cast<T>(MIN / 10), static_cast<T>(MAX / 7) };
+    for (int scale = 0; scale >= -18; scale--) {
+        for (const T value : values) {
+            char buffer[NumericFormatter::SCALED_INTEGER_STRING_SIZE];
+            const auto text = NumericFormatter::formatScaledInteger(value, scale, buffer);
+            CHECK_EQUAL(text, referenceScaled(value, scale));
+        }
+    }
+}
+
+// Decimal digits of the 128-bit magnitude, computed by long division of 32-bit limbs by 10.
+std::string referenceDigits(uint64_t high, uint64_t low)
+{
+    uint32_t limbs[4] = { static_cast<uint32_t>(high >> 32), static_cast<uint32_t>(high),
+        static_cast<uint32_t>(low >> 32), static_cast<uint32_t>(low) };
+    std::string reversed;
+    do {
+        uint64_t remainder = 0;
+        for (auto& limb : limbs) {
+            const uint64_t current = (remainder << 32) | limb;
+            limb = static_cast<uint32_t>(current / 10);
+            remainder = current % 10;
+        }
+        reversed += static_cast<char>('0' + remainder);
+    } while ((limbs[0] | limbs[1] | limbs[2] | limbs[3]) != 0);
+    return std::string(reversed.rbegin(), reversed.rend());
+}
+
+// The layout of Firebird's Int128::toString: an exponent outside -38..4, trailing zeros
+// for positive scales, otherwise a decimal point with at least one digit before it.
+std::string referenceInt128(bool negative, uint64_t high, uint64_t low, int scale)
+{
+    std::string s = referenceDigits(high, low);
+    if (scale < -38 || scale > 4) {
+        s += 'E';
+        s += std::to_string(scale);
+    } else if (scale > 0) {
+        s += std::string(static_cast<size_t>(scale), '0');
+    } else if (scale < 0) {
+        const auto fraction = static_cast<size_t>(-scale);
+        if (fraction > s.size()) {
+            s = std::string(fraction - s.size(), '0') + s;
+        }
+        if (fraction == s.size()) {
+            s = std::string("0.").append(s);
+        } else {
+            s = s.substr(0, s.size() - fraction) + "." + s.substr(s.size() - fraction);
+        }
+    }
+    if (!negative) {
+        return s;
+    }
+    std::string result(1, '-');
+    result += s;
+    return result;
+}
+
+// Builds the value from its sign and magnitude, the magnitude must fit.
+FB_I128 makeInt128(bool negative, uint64_t high, uint64_t low)
+{
+    FB_I128 value;
+    value.fb_data[0] = low;
+    value.fb_data[1] = high;
+    if (negative) {
+        value.fb_data[0] = ~low + 1;
+        value.fb_data[1] = ~high + (value.fb_data[0] == 0 ? 1 : 0);
+    }
+    return value;
+}
+
+void checkInt128(bool negative, uint64_t high, uint64_t low, int scale)
+{
+    char buffer[NumericFormatter::INT128_STRING_SIZE];
+    const auto text = NumericFormatter::formatInt128(makeInt128(negative, high, low), scale, buffer);
+    CHECK_EQUAL(text, referenceInt128(negative, high, low, scale));
+}
+
+} // namespace
+
+namespace SimpleJsonTests {
+
+void testScaledIntegers()
+{
+    checkCases(smallintCases);
+    checkCases(integerCases);
+    checkCases(bigintCases);
+    checkCases(otherScaleCases);
+
+    checkAllScales<int16_t>();
+    checkAllScales<int32_t>();
+    checkAllScales<int64_t>();
+}
+
+void testInt128()
+{
+    constexpr uint64_t MAX_HIGH = 0x7FFFFFFFFFFFFFFFULL;
+    char buffer[NumericFormatter::INT128_STRING_SIZE];
+
+    // the extremes
+    CHECK_EQUAL(NumericFormatter::formatInt128(makeInt128(false, MAX_HIGH, ~0ULL), 0, buffer),
+        std::string_view("170141183460469231731687303715884105727"));
+    CHECK_EQUAL(NumericFormatter::formatInt128(makeInt128(true, 0x8000000000000000ULL, 0), 0, buffer),
+        std::string_view("-170141183460469231731687303715884105728"));
+    CHECK_EQUAL(NumericFormatter::formatInt128(makeInt128(true, 0x8000000000000000ULL, 0), -38, buffer),
+        std::string_view("-1.70141183460469231731687303715884105728"));
+    CHECK_EQUAL(NumericFormatter::formatInt128(makeInt128(false, 0, 0), -3, buffer), std::string_view("0.000"));
+    CHECK_EQUAL(NumericFormatter::formatInt128(makeInt128(true, 0, 5), -3, buffer), std::string_view("-0.005"));
+    CHECK_EQUAL(NumericFormatter::formatInt128(makeInt128(true, 0, 12345), -2, buffer), std::string_view("-123.45"));
+
+    // every scale for values around the 64-bit boundary
+    for (int scale = -40; scale <= 6; scale++) {
+        checkInt128(false, 0, ~0ULL, scale);
+        checkInt128(true, 1, 0, scale);
+        checkInt128(false, MAX_HIGH, ~0ULL, scale);
+        checkInt128(true, 0x8000000000000000ULL, 0, scale);
+        checkInt128(false, 0, 1, scale);
+    }
+
+    // random magnitudes of every length, the seed is fixed for repeatable runs
+    std::mt19937_64 random(20261017);
+    for (int i = 0; i < 200000; i++) {
+        const auto bits = static_cast<unsigned>(random() % 128);
+        uint64_t high = random();
+        uint64_t low = random();
+        if (bits <= 64) {
+            high = 0;
+            low = (bits == 0) ? 0 : low >> (64 - bits);
+        } else {
+            high >>= (128 - bits);
+        }
+        // there is no negative zero
+        const bool negative = (random() & 1) != 0 && (high | low) != 0;
+        const auto scale = static_cast<int>(random() % 47) - 40;
+        checkInt128(negative, high, low, scale);
+    }
+}
+
+} // namespace SimpleJsonTests
@@ -0,0 +1,74 @@
+#include <cstdio>
+#include <exception>
+#include <string>
+
+#include "TestChecks.h"
+#include "Tests.h"
+
+namespace {
+
+size_t failureCount = 0;
+
+struct TestGroup {
+    const char* name;
+    void (*run)();
+};
+
+const TestGroup testGroups[] = {
+    { "scaled-integers", SimpleJsonTests::testScaledIntegers },
+    { "int128", SimpleJsonTests::testInt128 },
+    { "json-writer", SimpleJsonTests::testJsonWriter },
+    { "async-writer", SimpleJsonTests::testAsyncFileWriter },
+    { "transcoder", SimpleJsonTests::testSingleByteTranscoder },
+    { "hex", SimpleJsonTests::testHexEncoding },
+    { "base64", SimpleJsonTests::testBase64Encoding },
+    { "date-time", SimpleJsonTests::testDateTimeFormatter },
+    { "event-buffer", SimpleJsonTests::testEventBuffer },
+    { "transaction-grouping", SimpleJsonTests::testTransactionGrouping }
+};
+
+} // namespace
+
+namespace SimpleJsonTests {
+
+void reportFailure(const char* file, int line, const std::string& message)
+{
+    ++failureCount;
+    fprintf(stderr, "%s(%d): %s\n", file, line, message.c_str());
+}
+
+size_t getFailureCount()
+{
+    return failureCount;
+}
+
+} // namespace SimpleJsonTests
+
+// Runs all test groups or the ones given by name, the exit code is 1 if a check fails.
+int main(int argc, char* argv[])
+{
+    int failedGroups = 0;
+    for (const auto& group : testGroups) {
+        bool selected = (argc < 2);
+        for (int i = 1; i < argc; i++) {
+            selected = selected || (argv[i] == std::string(group.name));
+        }
+        if (!selected) {
+            continue;
+        }
+        const auto failuresBefore = failureCount;
+        try {
+            group.run();
+        } catch (const std::exception& e) {
+            SimpleJsonTests::reportFailure(__FILE__, __LINE__, std::string("unexpected exception: ") + e.what());
+        }
+        const auto failures = failureCount - failuresBefore;
+        if (failures == 0) {
+            printf("%-20s OK\n", group.name);
+        } else {
+            printf("%-20s FAILED (%zu)\n", group.name, failures);
+            ++failedGroups;
+        }
+    }
+    return failedGroups == 0 ? 0 : 1;
+}
@@ -0,0 +1,38 @@
+#pragma once
+#ifndef SIMPLE_JSON_TESTS_TEST_CHECKS_H
+#define SIMPLE_JSON_TESTS_TEST_CHECKS_H
+
+#include <cstddef>
+#include <sstream>
+#include <string>
+
+// Checks of the test executable. A failed check is reported and the test goes on,
+// so that one run shows all differences.
+namespace SimpleJsonTests {
+
+void reportFailure(const char* file, int line, const std::string& message);
+// Number of failed checks since the start of the program.
+size_t getFailureCount();
+
+template <typename Actual, typename Expected>
+void checkEqual(const Actual& actual, const Expected& expected, const char* expression, const char* file, int line)
+{
+    if (!(actual == expected)) {
+        std::ostringstream message;
+        message << expression << ": got \"" << actual << "\", expected \"" << expected << "\"";
+        reportFailure(file, line, message.str());
+    }
+}
+
+} // namespace SimpleJsonTests
+
+#define CHECK(condition)                                                                        \
+    do {                                                                                        \
+        if (!(condition)) {                                                                     \
+            ::SimpleJsonTests::reportFailure(__FILE__, __LINE__, "check failed: " #condition); \
+        }                                                                                       \
+    } while (false)
+
+#define CHECK_EQUAL(actual, expected) ::SimpleJsonTests::checkEqual((actual), (expected), #actual, __FILE__, __LINE__)
+
+#endif // SIMPLE_JSON_TESTS_TEST_CHECKS_H
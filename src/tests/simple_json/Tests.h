@@ -0,0 +1,32 @@
+#pragma once
+#ifndef SIMPLE_JSON_TESTS_TESTS_H
+#define SIMPLE_JSON_TESTS_TESTS_H
+
+// Test groups of simple_json_tests, each checks one building block of the plugin.
+namespace SimpleJsonTests {
+
+// SMALLINT, INTEGER and BIGINT values with a scale.
+void testScaledIntegers();
+// INT128 values with a scale, the same text as IInt128::toString.
+void testInt128();
+// JsonWriter against nlohmann::json::dump(), doubles in particular.
+void testJsonWriter();
+// AsyncFileWriter with a short queue, the threads wait for each other.
+void testAsyncFileWriter();
+// SingleByteTranscoder against the converter it was built from.
+void testSingleByteTranscoder();
+// Hex encoding at every instruction set the processor has against the scalar one.
+void testHexEncoding();
+// Base64 encoding, RFC 4648 vectors and every instruction set against the scalar one.
+void testBase64Encoding();
+// DATE, TIME and TIMESTAMP text, every date of years 1..9999 against an independent calendar.
+void testDateTimeFormatter();
+// EventBuffer savepoints, released, rolled back and nested.
+void testEventBuffer();
+// The plugin with transactionGrouping, only committed work reaches the segment and its blob file,
+// arrow and parquet files too if the plugin is built with them.
+void testTransactionGrouping();
+
+} // namespace SimpleJsonTests
+
+#endif // SIMPLE_JSON_TESTS_TESTS_H
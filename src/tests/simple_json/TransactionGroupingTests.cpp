@@ -0,0 +1,388 @@
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#ifdef HAVE_ARROW
+#include <arrow/api.h>
+#include <arrow/io/file.h>
+#include <arrow/ipc/reader.h>
+#include <parquet/arrow/reader.h>
+#endif
+#include <nlohmann/json.hpp>
+
+#include "../../benchmark/simple_json/BenchmarkMocks.h"
+#include "../../common/EventBuffer.h"
+#include "../../common/charsets.h"
+#include "../../include/StreamingInterface.h"
+#include "../../plugins/simple_json/SimpleJsonPlugin.h"
+#include "TestChecks.h"
+#include "Tests.h"
+
+namespace fs = std::filesystem;
+
+using namespace Firebird;
+
+namespace {
+
+using FbUtils::EventBuffer;
+using SimpleJsonBenchmark::MockConfig;
+using SimpleJsonBenchmark::MockEncodeUtils;
+using SimpleJsonBenchmark::MockLogger;
+using SimpleJsonBenchmark::MockRecord;
+
+// The events of the buffer as "kind:event" separated by spaces.
+std::string listEvents(const EventBuffer& events)
+{
+    std::string text;
+    events.forEach([&text](std::string_view event, unsigned kind) {
+        if (!text.empty()) {
+            text += ' ';
+        }
+        text += std::to_string(kind) + ':' + std::string(event);
+    });
+    return text;
+}
+
+std::string readFile(const fs::path& fileName)
+{
+    std::ifstream file(fileName, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+// The events of a segment file in short form, e.g. "INSERT 3 ID=7" or "STORE BLOB 3 0+200", one per line.
+std::string readSegmentEvents(const fs::path& fileName, bool ndjson)
+{
+    std::vector<nlohmann::json> events;
+    const auto text = readFile(fileName);
+    if (ndjson) {
+        size_t start = 0;
+        while (start < text.size()) {
+            const auto end = text.find('\n', start);
+            const auto line = nlohmann::json::parse(text.substr(start, end - start));
+            if (line.contains("event")) {
+                events.push_back(line);
+            }
+            start = (end == std::string::npos) ? text.size() : end + 1;
+        }
+    } else {
+        const auto document = nlohmann::json::parse(text);
+        events = document["events"].get<std::vector<nlohmann::json>>();
+    }
+
+    std::string result;
+    for (const auto& event : events) {
+        auto line = event["event"].get<std::string>() + " " + std::to_string(event["tnx"].get<int64_t>());
+        if (event.contains("record")) {
+            line += " ID=" + std::to_string(event["record"]["ID"].get<int64_t>());
+        }
+        if (event.contains("file")) {
+            line += " " + std::to_string(event["offset"].get<uint64_t>()) + "+" + std::to_string(event["length"].get<uint64_t>());
+        }
+        result += line + "\n";
+    }
+    return result;
+}
+
+// Passes the events of a segment to the plugin the same way fb_streaming does.
+class SegmentFeeder final {
+public:
+    SegmentFeeder(ThrowStatusWrapper* status, IStreamPlugin* plugin)
+        : m_status(status)
+        , m_plugin(plugin)
+    {
+        m_record.addField("ID", SQL_LONG, 0, 0, sizeof(ISC_LONG), CS_NONE);
+    }
+
+    void startSegment(unsigned sequence)
+    {
+        SegmentHeaderInfo header {};
+        snprintf(header.name, sizeof(header.name), "grouping.%u", sequence);
+        snprintf(header.guid, sizeof(header.guid), "{7D3A2C5E-1B4F-4E8A-9C6D-0F2E8B7A5D31}");
+        header.version = 1;
+        header.sequence = sequence;
+        header.state = 3;
+        m_plugin->startSegment(m_status, &header);
+    }
+
+    void insert(IStreamedTransaction* transaction, ISC_LONG id)
+    {
+        m_record.field(0).setData(&id, sizeof(id));
+        transaction->insertRecord(m_status, "T", &m_record);
+    }
+
+    // A blob of size bytes, all of them the character fill.
+    void storeBlob(IStreamedTransaction* transaction, ISC_LONG id, size_t size, char fill)
+    {
+        ISC_QUAD blobId { 0, static_cast<ISC_ULONG>(id) };
+        const std::string data(size, fill);
+        transaction->storeBlob(m_status, &blobId, static_cast<ISC_INT64>(size),
+            reinterpret_cast<const unsigned char*>(data.data()));
+    }
+
+    void commit(IStreamedTransaction* transaction, ISC_INT64 number)
+    {
+        transaction->prepare(m_status);
+        transaction->commit(m_status);
+        m_plugin->cleanupTransaction(m_status, number);
+        transaction->dispose();
+    }
+
+    void rollback(IStreamedTransaction* transaction, ISC_INT64 number)
+    {
+        transaction->rollback(m_status);
+        m_plugin->cleanupTransaction(m_status, number);
+        transaction->dispose();
+    }
+
+private:
+    ThrowStatusWrapper* m_status;
+    IStreamPlugin* m_plugin;
+    MockRecord m_record;
+};
+
+// Two segments of interleaved transactions with savepoints, two of them end in the second one.
+// Blobs over 100 bytes are spilled, those of rolled back work are filled with 'r'.
+void runGroupedSegments(ThrowStatusWrapper* status, IStreamPlugin* plugin)
+{
+    SegmentFeeder feeder(status, plugin);
+
+    feeder.startSegment(1);
+    auto t1 = plugin->startTransaction(status, 1);
+    feeder.insert(t1, 1);
+    t1->startSavepoint(status);
+    feeder.insert(t1, 2);
+    feeder.storeBlob(t1, 2, 300, 'r');
+    t1->rollbackSavepoint(status);
+    t1->startSavepoint(status);
+    feeder.insert(t1, 3);
+    t1->startSavepoint(status);
+    feeder.insert(t1, 4);
+    t1->releaseSavepoint(status);
+    t1->releaseSavepoint(status);
+    feeder.storeBlob(t1, 5, 200, 'c');
+
+    auto t2 = plugin->startTransaction(status, 2);
+    feeder.insert(t2, 10);
+    t2->startSavepoint(status);
+    feeder.storeBlob(t2, 11, 150, 'r');
+    feeder.insert(t2, 11);
+    t2->rollbackSavepoint(status);
+    feeder.storeBlob(t2, 12, 120, 'r');
+
+    // a savepoint rolled back together with a released one inside it
+    auto t3 = plugin->startTransaction(status, 3);
+    feeder.insert(t3, 30);
+    t3->startSavepoint(status);
+    feeder.insert(t3, 31);
+    t3->startSavepoint(status);
+    feeder.insert(t3, 32);
+    feeder.storeBlob(t3, 32, 400, 'r');
+    t3->releaseSavepoint(status);
+    t3->rollbackSavepoint(status);
+    feeder.commit(t3, 3);
+    plugin->finishSegment(status);
+
+    // DDL drops the cached layouts while the rows of transaction 1 wait for the commit
+    feeder.startSegment(2);
+    feeder.insert(t2, 13);
+    t2->executeSql(status, "ALTER TABLE T ADD C INTEGER");
+    feeder.rollback(t2, 2);
+    t1->startSavepoint(status);
+    feeder.storeBlob(t1, 6, 150, 'd');
+    t1->releaseSavepoint(status);
+    feeder.commit(t1, 1);
+    plugin->finishSegment(status);
+}
+
+// Runs runGroupedSegments with output to a new directory.
+fs::path runPlugin(std::initializer_list<std::pair<const char*, const char*>> parameters)
+{
+    const auto directory = fs::temp_directory_path() / "simple_json_tests_transaction_grouping";
+    fs::remove_all(directory);
+    fs::create_directories(directory);
+
+    auto config = new MockConfig();
+    config->setValue("outputDir", directory.string());
+    config->setValue("dumpBlobs", "true");
+    config->setValue("blobSpillThreshold", "100");
+    for (const auto& [name, value] : parameters) {
+        config->setValue(name, value);
+    }
+
+    auto master = fb_get_master_interface();
+    ThrowStatusWrapper status(master->getStatus());
+    MockLogger logger;
+    MockEncodeUtils encodeUtils;
+    try {
+        SimpleJsonPlugin::SimpleJsonPluginFactory factory(master);
+        auto plugin = factory.createPlugin(&status, config, &encodeUtils, &logger);
+        plugin->init(&status, nullptr);
+        runGroupedSegments(&status, plugin);
+        plugin->finish(&status);
+        plugin->release();
+    } catch (const FbException& e) {
+        char message[1024];
+        master->getUtilInterface()->formatStatus(message, sizeof(message), e.getStatus());
+        SimpleJsonTests::reportFailure(__FILE__, __LINE__, std::string("plugin error: ") + message);
+    }
+    config->release();
+    status.dispose();
+    return directory;
+}
+
+void checkGroupedOutput(const char* outputFormat, bool streaming)
+{
+    const auto directory = runPlugin({ { "outputFormat", outputFormat }, { "streamingOutput", streaming ? "true" : "false" },
+        { "transactionGrouping", "true" } });
+
+    const std::string extension = std::string(".") + outputFormat;
+    const bool ndjson = (extension == ".ndjson");
+    const std::string firstSegment =
+        "START TRANSACTION 3\n"
+        "INSERT 3 ID=30\n"
+        "PREPARE TRANSACTION 3\n"
+        "COMMIT 3\n";
+    CHECK_EQUAL(readSegmentEvents(directory / ("grouping.1" + extension), ndjson), firstSegment);
+    // nothing committed in the first segment was spilled
+    CHECK(!fs::exists(directory / "grouping.1.blobs"));
+
+    const std::string secondSegment =
+        "START TRANSACTION 1\n"
+        "INSERT 1 ID=1\n"
+        "INSERT 1 ID=3\n"
+        "INSERT 1 ID=4\n"
+        "STORE BLOB 1 0+200\n"
+        "STORE BLOB 1 200+150\n"
+        "PREPARE TRANSACTION 1\n"
+        "COMMIT 1\n";
+    CHECK_EQUAL(readSegmentEvents(directory / ("grouping.2" + extension), ndjson), secondSegment);
+    CHECK_EQUAL(readFile(directory / "grouping.2.blobs"), std::string(200, 'c') + std::string(150, 'd'));
+}
+
+#ifdef HAVE_ARROW
+template <typename T>
+T valueOrThrow(arrow::Result<T>&& result)
+{
+    if (!result.ok()) {
+        throw std::runtime_error(result.status().ToString());
+    }
+    return std::move(result).ValueUnsafe();
+}
+
+// The rows of a table file in short form, e.g. "INSERT 3 ID=7", one per line.
+std::string readColumnarRows(const fs::path& fileName, bool parquet)
+{
+    const auto file = valueOrThrow(arrow::io::ReadableFile::Open(fileName.string()));
+    std::shared_ptr<arrow::Table> table;
+    if (parquet) {
+        const auto reader = valueOrThrow(parquet::arrow::OpenFile(file, arrow::default_memory_pool()));
+        table = valueOrThrow(reader->ReadTable());
+    } else {
+        const auto reader = valueOrThrow(arrow::ipc::RecordBatchStreamReader::Open(file));
+        table = valueOrThrow(reader->ToTable());
+    }
+    table = valueOrThrow(table->CombineChunks());
+
+    const auto operations = std::static_pointer_cast<arrow::StringArray>(table->GetColumnByName("operation")->chunk(0));
+    const auto transactions = std::static_pointer_cast<arrow::Int64Array>(table->GetColumnByName("tnx")->chunk(0));
+    const auto ids = std::static_pointer_cast<arrow::Int32Array>(table->GetColumnByName("ID")->chunk(0));
+    std::string result;
+    for (int64_t i = 0; i < table->num_rows(); i++) {
+        result += std::string(operations->GetView(i)) + " " + std::to_string(transactions->Value(i))
+            + " ID=" + std::to_string(ids->Value(i)) + "\n";
+    }
+    return result;
+}
+
+// Columnar output always groups the rows, the files have no transaction events.
+void checkColumnarOutput(const char* outputFormat)
+{
+    const auto directory = runPlugin({ { "outputFormat", outputFormat } });
+
+    const bool parquet = (std::string(outputFormat) == "parquet");
+    const auto tableFile = parquet ? "T.parquet" : "T.arrows";
+    const auto extension = std::string(".") + outputFormat;
+    CHECK_EQUAL(readColumnarRows(directory / ("grouping.1" + extension) / tableFile, parquet), std::string("INSERT 3 ID=30\n"));
+    CHECK_EQUAL(readColumnarRows(directory / ("grouping.2" + extension) / tableFile, parquet),
+        std::string("INSERT 1 ID=1\nINSERT 1 ID=3\nINSERT 1 ID=4\n"));
+    CHECK(!fs::exists(directory / "grouping.2.blobs"));
+}
+#endif
+
+} // namespace
+
+namespace SimpleJsonTests {
+
+void testEventBuffer()
+{
+    EventBuffer events;
+    CHECK(events.empty());
+    events.append("a");
+    events.append({ "b", "c" }, 1);
+    CHECK_EQUAL(listEvents(events), std::string("0:a 1:bc"));
+
+    // nested savepoints, the inner one is released into the outer one
+    events.startSavepoint();
+    events.append("d");
+    events.startSavepoint();
+    events.append("e", 1);
+    events.releaseSavepoint();
+    CHECK_EQUAL(listEvents(events), std::string("0:a 1:bc 0:d 1:e"));
+    events.rollbackSavepoint();
+    CHECK_EQUAL(listEvents(events), std::string("0:a 1:bc"));
+
+    // a released savepoint keeps its events, a rolled back one after it does not touch them
+    events.startSavepoint();
+    events.append("f");
+    events.releaseSavepoint();
+    events.startSavepoint();
+    events.append("g");
+    events.startSavepoint();
+    events.append("h");
+    events.rollbackSavepoint();
+    events.append("i");
+    events.releaseSavepoint();
+    CHECK_EQUAL(listEvents(events), std::string("0:a 1:bc 0:f 0:g 0:i"));
+    CHECK_EQUAL(events.size(), size_t { 5 });
+
+    // without a savepoint both do nothing
+    events.rollbackSavepoint();
+    events.releaseSavepoint();
+    CHECK_EQUAL(listEvents(events), std::string("0:a 1:bc 0:f 0:g 0:i"));
+
+    // clear() drops the savepoints too
+    events.startSavepoint();
+    events.append("j");
+    events.clear();
+    CHECK(events.empty());
+    events.append("k");
+    events.rollbackSavepoint();
+    CHECK_EQUAL(listEvents(events), std::string("0:k"));
+
+    // an event larger than the retained memory, the buffer is usable after clear()
+    const std::string large(EventBuffer::MAX_RETAINED_SIZE + 1, 'x');
+    events.append(large, 1);
+    events.clear();
+    events.append("l");
+    CHECK_EQUAL(listEvents(events), std::string("0:l"));
+}
+
+void testTransactionGrouping()
+{
+    checkGroupedOutput("json", false);
+    checkGroupedOutput("ndjson", true);
+#ifdef HAVE_ARROW
+    checkColumnarOutput("arrow");
+    checkColumnarOutput("parquet");
+#endif
+}
+
+} // namespace SimpleJsonTests
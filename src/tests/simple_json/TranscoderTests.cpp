@@ -0,0 +1,91 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../../benchmark/simple_json/BenchmarkMocks.h"
+#include "../../common/charsets.h"
+#include "../../encoding/SingleByteTranscoder.h"
+#include "TestChecks.h"
+#include "Tests.h"
+
+using namespace Firebird;
+
+namespace {
+
+// ASCII below 0x80, the upper half has characters of two and three UTF-8 bytes
+std::array<char32_t, 256> makeCodePoints()
+{
+    std::array<char32_t, 256> codePoints {};
+    for (unsigned i = 0; i < 0x80; i++) {
+        codePoints[i] = i;
+    }
+    for (unsigned i = 0x80; i < 0xC0; i++) {
+        codePoints[i] = 0x0400 + (i - 0x80);
+    }
+    for (unsigned i = 0xC0; i < 0x100; i++) {
+        codePoints[i] = 0x2000 + (i - 0xC0);
+    }
+    return codePoints;
+}
+
+// A text of ASCII runs and non-ASCII bytes, the share of ASCII varies from text to text.
+std::string makeText(std::mt19937_64& random, size_t length)
+{
+    const auto asciiPercent = random() % 101;
+    std::string text(length, '\0');
+    size_t pos = 0;
+    while (pos < length) {
+        // runs up to twice the AVX2 chunk, so that every chunk boundary is crossed
+        const auto run = std::min<size_t>(length - pos, 1 + random() % 64);
+        const bool ascii = (random() % 100) < asciiPercent;
+        for (size_t i = 0; i < run; i++) {
+            text[pos + i] = static_cast<char>(ascii ? random() % 0x80 : 0x80 + random() % 0x80);
+        }
+        pos += run;
+    }
+    return text;
+}
+
+} // namespace
+
+namespace SimpleJsonTests {
+
+void testSingleByteTranscoder()
+{
+    ThrowStatusWrapper status(nullptr);
+    SimpleJsonBenchmark::MockStringConverter converter(CS_WIN1251, "WIN1251", makeCodePoints());
+    const auto transcoder = SingleByteTranscoder::create(&status, &converter);
+    CHECK(transcoder != nullptr);
+    if (!transcoder) {
+        return;
+    }
+
+    // the fixed seed makes the texts the same in every run
+    std::mt19937_64 random(20261017);
+    std::string source;
+    for (int i = 0; i < 20000; i++) {
+        const auto length = static_cast<size_t>(random() % 300);
+        // the text starts at any offset of a 32-byte chunk, so the loads are unaligned
+        const auto offset = static_cast<size_t>(random() % 32);
+        source.assign(offset, 'x');
+        source += makeText(random, length);
+        const char* text = source.data() + offset;
+
+        std::vector<char> expected(length * SingleByteTranscoder::MAX_UTF8_CHAR_LENGTH);
+        const auto expectedLength = converter.toUtf8(&status, text, length, expected.data(), expected.size());
+        // the buffer has exactly the documented size, a write past it is noticed by a sanitizer
+        std::vector<char> actual(length * SingleByteTranscoder::MAX_UTF8_CHAR_LENGTH);
+        const auto actualLength = transcoder->toUtf8(text, length, actual.data());
+
+        CHECK_EQUAL(actualLength, static_cast<size_t>(expectedLength));
+        if (actualLength == expectedLength) {
+            CHECK(std::string_view(actual.data(), actualLength) == std::string_view(expected.data(), actualLength));
+        }
+    }
+}
+
+} // namespace SimpleJsonTests